@@ -46,7 +46,8 @@
 
 #define configUSE_PREEMPTION                    1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
-#define configUSE_TICKLESS_IDLE                 0
+#define configUSE_TICKLESS_IDLE                 2   /* own implementation, power.c */
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
 #define configCPU_CLOCK_HZ                      SystemCoreClock
 #define configTICK_RATE_HZ                      1000u
 #define configMAX_PRIORITIES                    7
@@ -66,9 +67,20 @@
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
 
 /* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION         0
+/* 1: every task, queue, semaphore and timer lives in a statically sized
+   buffer and nothing is taken from the heap, so it shrinks to a token
+   (tools/ramreport.py); 0: they are taken from the heap_4 heap as before.
+   Dynamic allocation stays on because heap_4.c is built either way and
+   diag.c reports its free size. */
+#ifndef configSUPPORT_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION         1
+#endif
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+#define configTOTAL_HEAP_SIZE                   (1*1024)
+#else
 #define configTOTAL_HEAP_SIZE                   (48*1024)
+#endif
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
@@ -79,8 +91,9 @@
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
-#define configUSE_TRACE_FACILITY                0
+/* Counted on TCPWM0 counter 3 at 1 MHz, reported by diag.c */
+#define configGENERATE_RUN_TIME_STATS           1
+#define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
 /* Co-routine related definitions. */
@@ -173,7 +186,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
 #define INCLUDE_xTaskGetIdleTaskHandle          0
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xEventGroupSetBitFromISR        1
@@ -186,6 +199,16 @@ to exclude the API function. */
 header file. */
 #define configASSERT( x ) if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ;; ); }
 
+/* Tickless idle: the SysTick stops and the CM4 sleeps on the MCWDT (power.c) */
+extern void Power_Sleep( uint32_t idleTicks );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) Power_Sleep( xExpectedIdleTime )
+
+/* Run time counter (diag.c) */
+extern void Diag_InitTimer( void );
+extern uint32_t Diag_GetTime( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() Diag_InitTimer()
+#define portGET_RUN_TIME_COUNTER_VALUE() Diag_GetTime()
+
 /* Definitions that map the FreeRTOS port interrupt handlers to their CMSIS
 standard names - or at least those used in the unmodified vector table. */
 #define vPortSVCHandler     SVC_Handler
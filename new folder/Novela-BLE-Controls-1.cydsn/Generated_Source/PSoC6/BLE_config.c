@@ -119,74 +119,74 @@ cy_stc_ble_gapp_disc_mode_info_t cy_ble_discoveryModeInfo[0x01u] = {
     {
         { 0x00u }, 
         {{
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         },
         {
-            0x00u, 0x00u, 
+            0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
             0x00u /* CRC */
         }}, 
-        0x02u, /* CY_BLE_GATT_DB_CCCD_COUNT */ 
+        0x0Au, /* CY_BLE_GATT_DB_CCCD_COUNT */ 
         0x11u, 
     };
 #endif /* (CY_BLE_MODE_PROFILE) */
@@ -209,7 +209,7 @@ static const cy_stc_ble_gaps_t cy_ble_gaps =
     0x0009u,    /* Handle of the Central Address Resolution characteristic */
     CY_BLE_GATT_INVALID_ATTR_HANDLE_VALUE, /* Handle of the Resolvable Private Address Only characteristic */
 };
-static uint8_t cy_ble_attValues[0x8Eu] = {
+static uint8_t cy_ble_attValues[0x6EAu] = {
     /* Device Name */
     (uint8_t)'N', (uint8_t)'o', (uint8_t)'v', (uint8_t)'e', (uint8_t)'l', (uint8_t)'a', (uint8_t)'P', (uint8_t)'r',
 (uint8_t)'o', (uint8_t)'b', (uint8_t)'e', 
@@ -268,12 +268,268 @@ static uint8_t cy_ble_attValues[0x8Eu] = {
 (uint8_t)'f', (uint8_t)'i', (uint8_t)'g', (uint8_t)'u', (uint8_t)'r', (uint8_t)'a', (uint8_t)'t', (uint8_t)'i',
 (uint8_t)'o', (uint8_t)'n', 
 
+    /* STREAM */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'S', (uint8_t)'a', (uint8_t)'m', (uint8_t)'p', (uint8_t)'l', (uint8_t)'e', (uint8_t)' ', (uint8_t)'S',
+(uint8_t)'t', (uint8_t)'r', (uint8_t)'e', (uint8_t)'a', (uint8_t)'m', 
+
+    /* CONFIG */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'F', (uint8_t)'r', (uint8_t)'o', (uint8_t)'n', (uint8_t)'t', (uint8_t)' ', (uint8_t)'E', (uint8_t)'n',
+(uint8_t)'d', (uint8_t)' ', (uint8_t)'C', (uint8_t)'o', (uint8_t)'n', (uint8_t)'f', (uint8_t)'i', (uint8_t)'g',
+(uint8_t)'u', (uint8_t)'r', (uint8_t)'a', (uint8_t)'t', (uint8_t)'i', (uint8_t)'o', (uint8_t)'n', 
+
+    /* STATUS */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'C', (uint8_t)'o', (uint8_t)'m', (uint8_t)'m', (uint8_t)'a', (uint8_t)'n', (uint8_t)'d', (uint8_t)' ',
+(uint8_t)'S', (uint8_t)'t', (uint8_t)'a', (uint8_t)'t', (uint8_t)'u', (uint8_t)'s', 
+
+    /* SEQ */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'M', (uint8_t)'U', (uint8_t)'X', (uint8_t)' ', (uint8_t)'S', (uint8_t)'c', (uint8_t)'a', (uint8_t)'n',
+(uint8_t)' ', (uint8_t)'S', (uint8_t)'e', (uint8_t)'q', (uint8_t)'u', (uint8_t)'e', (uint8_t)'n', (uint8_t)'c',
+(uint8_t)'e', 
+
+    /* LOGLEVEL */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'L', (uint8_t)'o', (uint8_t)'g', (uint8_t)' ', (uint8_t)'L', (uint8_t)'e', (uint8_t)'v', (uint8_t)'e',
+(uint8_t)'l', (uint8_t)'s', 
+
+    /* DIAG */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'R', (uint8_t)'u', (uint8_t)'n', (uint8_t)' ', (uint8_t)'T', (uint8_t)'i', (uint8_t)'m', (uint8_t)'e',
+(uint8_t)' ', (uint8_t)'S', (uint8_t)'t', (uint8_t)'a', (uint8_t)'t', (uint8_t)'i', (uint8_t)'s', (uint8_t)'t',
+(uint8_t)'i', (uint8_t)'c', (uint8_t)'s', 
+
+    /* LATENCY */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'E', (uint8_t)'v', (uint8_t)'e', (uint8_t)'n', (uint8_t)'t', (uint8_t)' ', (uint8_t)'L', (uint8_t)'a',
+(uint8_t)'t', (uint8_t)'e', (uint8_t)'n', (uint8_t)'c', (uint8_t)'y', (uint8_t)' ', (uint8_t)'H', (uint8_t)'i',
+(uint8_t)'s', (uint8_t)'t', (uint8_t)'o', (uint8_t)'g', (uint8_t)'r', (uint8_t)'a', (uint8_t)'m', (uint8_t)'s', 
+
+    /* TIMESTAMP */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'T', (uint8_t)'i', (uint8_t)'m', (uint8_t)'e', (uint8_t)'s', (uint8_t)'t', (uint8_t)'a', (uint8_t)'m',
+(uint8_t)'p', (uint8_t)'s', 
+
+    /* DSP */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'F', (uint8_t)'i', (uint8_t)'l', (uint8_t)'t', (uint8_t)'e', (uint8_t)'r', (uint8_t)' ', (uint8_t)'a',
+(uint8_t)'n', (uint8_t)'d', (uint8_t)' ', (uint8_t)'D', (uint8_t)'e', (uint8_t)'c', (uint8_t)'i', (uint8_t)'m',
+(uint8_t)'a', (uint8_t)'t', (uint8_t)'i', (uint8_t)'o', (uint8_t)'n', 
+
+    /* FEATURES */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'W', (uint8_t)'i', (uint8_t)'n', (uint8_t)'d', (uint8_t)'o', (uint8_t)'w', (uint8_t)' ', (uint8_t)'F',
+(uint8_t)'e', (uint8_t)'a', (uint8_t)'t', (uint8_t)'u', (uint8_t)'r', (uint8_t)'e', (uint8_t)'s', 
+
+    /* STEPS */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 
+
+    /* Characteristic User Description */
+    (uint8_t)'T', (uint8_t)'i', (uint8_t)'m', (uint8_t)'e', (uint8_t)'d', (uint8_t)' ', (uint8_t)'R', (uint8_t)'e',
+(uint8_t)'g', (uint8_t)'i', (uint8_t)'s', (uint8_t)'t', (uint8_t)'e', (uint8_t)'r', (uint8_t)' ', (uint8_t)'S',
+(uint8_t)'t', (uint8_t)'e', (uint8_t)'p', (uint8_t)'s', 
+
 };
 #if(CY_BLE_GATT_DB_CCCD_COUNT != 0u)
 static uint8_t cy_ble_attValuesCCCD[CY_BLE_GATT_DB_CCCD_COUNT];
 #endif /* CY_BLE_GATT_DB_CCCD_COUNT != 0u */
 
-static cy_stc_ble_gatts_att_gen_val_len_t cy_ble_attValuesLen[0x10u] = {
+static cy_stc_ble_gatts_att_gen_val_len_t cy_ble_attValuesLen[0x2Au] = {
     { 0x000Bu, (void *)&cy_ble_attValues[0] }, /* Device Name */
     { 0x0002u, (void *)&cy_ble_attValues[11] }, /* Appearance */
     { 0x0008u, (void *)&cy_ble_attValues[13] }, /* Peripheral Preferred Connection Parameters */
@@ -290,9 +546,35 @@ static cy_stc_ble_gatts_att_gen_val_len_t cy_ble_attValuesLen[0x10u] = {
     { 0x0011u, (void *)&cy_ble_attValues[106] }, /* Characteristic User Description */
     { 0x0001u, (void *)&cy_ble_attValues[123] }, /* MISC */
     { 0x0012u, (void *)&cy_ble_attValues[124] }, /* Characteristic User Description */
+    { 0x00F4u, (void *)&cy_ble_attValues[142] }, /* STREAM */
+    { 0x0002u, (void *)&cy_ble_attValuesCCCD[2] }, /* Client Characteristic Configuration */
+    { 0x000Du, (void *)&cy_ble_attValues[386] }, /* Characteristic User Description */
+    { 0x0005u, (void *)&cy_ble_attValues[399] }, /* CONFIG */
+    { 0x0017u, (void *)&cy_ble_attValues[404] }, /* Characteristic User Description */
+    { 0x00F4u, (void *)&cy_ble_attValues[427] }, /* STATUS */
+    { 0x0002u, (void *)&cy_ble_attValuesCCCD[4] }, /* Client Characteristic Configuration */
+    { 0x000Eu, (void *)&cy_ble_attValues[671] }, /* Characteristic User Description */
+    { 0x0017u, (void *)&cy_ble_attValues[685] }, /* SEQ */
+    { 0x0011u, (void *)&cy_ble_attValues[708] }, /* Characteristic User Description */
+    { 0x0008u, (void *)&cy_ble_attValues[725] }, /* LOGLEVEL */
+    { 0x000Au, (void *)&cy_ble_attValues[733] }, /* Characteristic User Description */
+    { 0x0079u, (void *)&cy_ble_attValues[743] }, /* DIAG */
+    { 0x0013u, (void *)&cy_ble_attValues[864] }, /* Characteristic User Description */
+    { 0x01D4u, (void *)&cy_ble_attValues[883] }, /* LATENCY */
+    { 0x0018u, (void *)&cy_ble_attValues[1351] }, /* Characteristic User Description */
+    { 0x0028u, (void *)&cy_ble_attValues[1375] }, /* TIMESTAMP */
+    { 0x0002u, (void *)&cy_ble_attValuesCCCD[6] }, /* Client Characteristic Configuration */
+    { 0x000Au, (void *)&cy_ble_attValues[1415] }, /* Characteristic User Description */
+    { 0x0008u, (void *)&cy_ble_attValues[1425] }, /* DSP */
+    { 0x0015u, (void *)&cy_ble_attValues[1433] }, /* Characteristic User Description */
+    { 0x00D9u, (void *)&cy_ble_attValues[1454] }, /* FEATURES */
+    { 0x0002u, (void *)&cy_ble_attValuesCCCD[8] }, /* Client Characteristic Configuration */
+    { 0x000Fu, (void *)&cy_ble_attValues[1671] }, /* Characteristic User Description */
+    { 0x0040u, (void *)&cy_ble_attValues[1686] }, /* STEPS */
+    { 0x0014u, (void *)&cy_ble_attValues[1750] }, /* Characteristic User Description */
 };
 
-static const cy_stc_ble_gatts_db_t cy_ble_gattDB[0x1Du] = {
+static const cy_stc_ble_gatts_db_t cy_ble_gattDB[0x42u] = {
     { 0x0001u, 0x2800u /* Primary service                     */, 0x00000001u /*       */, 0x0009u, {{0x1800u, NULL}}                           },
     { 0x0002u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x0003u, {{0x2A00u, NULL}}                           },
     { 0x0003u, 0x2A00u /* Device Name                         */, 0x01020001u /* rd    */, 0x0003u, {{0x000Bu, (void *)&cy_ble_attValuesLen[0]}} },
@@ -306,22 +588,59 @@ static const cy_stc_ble_gatts_db_t cy_ble_gattDB[0x1Du] = {
     { 0x000Bu, 0x2803u /* Characteristic                      */, 0x00200001u /* ind   */, 0x000Du, {{0x2A05u, NULL}}                           },
     { 0x000Cu, 0x2A05u /* Service Changed                     */, 0x01200000u /* ind   */, 0x000Du, {{0x0004u, (void *)&cy_ble_attValuesLen[4]}} },
     { 0x000Du, 0x2902u /* Client Characteristic Configuration */, 0x030A0101u /* rd,wr */, 0x000Du, {{0x0002u, (void *)&cy_ble_attValuesLen[5]}} },
-    { 0x000Eu, 0x2800u /* Primary service                     */, 0x00000001u /*       */, 0x001Du, {{0x2011u, NULL}}                           },
-    { 0x000Fu, 0x2803u /* Characteristic                      */, 0x00080001u /* wr    */, 0x0011u, {{0xC000u, NULL}}                           },
-    { 0x0010u, 0xC000u /* GREEN                               */, 0x01080100u /* wr    */, 0x0011u, {{0x0001u, (void *)&cy_ble_attValuesLen[6]}} },
+    { 0x000Eu, 0x2800u /* Primary service                     */, 0x00000001u /*       */, 0x0042u, {{0x2011u, NULL}}                           },
+    { 0x000Fu, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x0011u, {{0xC000u, NULL}}                           },
+    { 0x0010u, 0xC000u /* GREEN                               */, 0x010C0100u /* wwr,wr */, 0x0011u, {{0x0001u, (void *)&cy_ble_attValuesLen[6]}} },
     { 0x0011u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0011u, {{0x0016u, (void *)&cy_ble_attValuesLen[7]}} },
-    { 0x0012u, 0x2803u /* Characteristic                      */, 0x00080001u /* wr    */, 0x0014u, {{0xC100u, NULL}}                           },
-    { 0x0013u, 0xC100u /* PA                                  */, 0x01080100u /* wr    */, 0x0014u, {{0x0001u, (void *)&cy_ble_attValuesLen[8]}} },
+    { 0x0012u, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x0014u, {{0xC100u, NULL}}                           },
+    { 0x0013u, 0xC100u /* PA                                  */, 0x010C0100u /* wwr,wr */, 0x0014u, {{0x0001u, (void *)&cy_ble_attValuesLen[8]}} },
     { 0x0014u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0014u, {{0x001Du, (void *)&cy_ble_attValuesLen[9]}} },
-    { 0x0015u, 0x2803u /* Characteristic                      */, 0x00080001u /* wr    */, 0x0017u, {{0xC200u, NULL}}                           },
-    { 0x0016u, 0xC200u /* MUX                                 */, 0x01080100u /* wr    */, 0x0017u, {{0x0001u, (void *)&cy_ble_attValuesLen[10]}} },
+    { 0x0015u, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x0017u, {{0xC200u, NULL}}                           },
+    { 0x0016u, 0xC200u /* MUX                                 */, 0x010C0100u /* wwr,wr */, 0x0017u, {{0x0001u, (void *)&cy_ble_attValuesLen[10]}} },
     { 0x0017u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0017u, {{0x0019u, (void *)&cy_ble_attValuesLen[11]}} },
-    { 0x0018u, 0x2803u /* Characteristic                      */, 0x00080001u /* wr    */, 0x001Au, {{0xC300u, NULL}}                           },
-    { 0x0019u, 0xC300u /* OSC                                 */, 0x01080100u /* wr    */, 0x001Au, {{0x0001u, (void *)&cy_ble_attValuesLen[12]}} },
+    { 0x0018u, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x001Au, {{0xC300u, NULL}}                           },
+    { 0x0019u, 0xC300u /* OSC                                 */, 0x010C0100u /* wwr,wr */, 0x001Au, {{0x0001u, (void *)&cy_ble_attValuesLen[12]}} },
     { 0x001Au, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x001Au, {{0x0011u, (void *)&cy_ble_attValuesLen[13]}} },
-    { 0x001Bu, 0x2803u /* Characteristic                      */, 0x00080001u /* wr    */, 0x001Du, {{0xC400u, NULL}}                           },
-    { 0x001Cu, 0xC400u /* MISC                                */, 0x01080100u /* wr    */, 0x001Du, {{0x0001u, (void *)&cy_ble_attValuesLen[14]}} },
+    { 0x001Bu, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x001Du, {{0xC400u, NULL}}                           },
+    { 0x001Cu, 0xC400u /* MISC                                */, 0x010C0100u /* wwr,wr */, 0x001Du, {{0x0001u, (void *)&cy_ble_attValuesLen[14]}} },
     { 0x001Du, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x001Du, {{0x0012u, (void *)&cy_ble_attValuesLen[15]}} },
+    { 0x001Eu, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x0021u, {{0xC500u, NULL}}                           },
+    { 0x001Fu, 0xC500u /* STREAM                              */, 0x01120001u /* rd,ntf */, 0x0021u, {{0x00F4u, (void *)&cy_ble_attValuesLen[16]}} },
+    { 0x0020u, 0x2902u /* Client Characteristic Configuration */, 0x030A0101u /* rd,wr */, 0x0021u, {{0x0002u, (void *)&cy_ble_attValuesLen[17]}} },
+    { 0x0021u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0021u, {{0x000Du, (void *)&cy_ble_attValuesLen[18]}} },
+    { 0x0022u, 0x2803u /* Characteristic                      */, 0x000E0001u /* rd,wwr,wr */, 0x0024u, {{0xC600u, NULL}}                           },
+    { 0x0023u, 0xC600u /* CONFIG                              */, 0x010E0101u /* rd,wwr,wr */, 0x0024u, {{0x0005u, (void *)&cy_ble_attValuesLen[19]}} },
+    { 0x0024u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0024u, {{0x0017u, (void *)&cy_ble_attValuesLen[20]}} },
+    { 0x0025u, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x0028u, {{0xC700u, NULL}}                           },
+    { 0x0026u, 0xC700u /* STATUS                              */, 0x01120001u /* rd,ntf */, 0x0028u, {{0x00F4u, (void *)&cy_ble_attValuesLen[21]}} },
+    { 0x0027u, 0x2902u /* Client Characteristic Configuration */, 0x030A0101u /* rd,wr */, 0x0028u, {{0x0002u, (void *)&cy_ble_attValuesLen[22]}} },
+    { 0x0028u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0028u, {{0x000Eu, (void *)&cy_ble_attValuesLen[23]}} },
+    { 0x0029u, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x002Bu, {{0xC800u, NULL}}                           },
+    { 0x002Au, 0xC800u /* SEQ                                 */, 0x010C0100u /* wwr,wr */, 0x002Bu, {{0x0017u, (void *)&cy_ble_attValuesLen[24]}} },
+    { 0x002Bu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x002Bu, {{0x0011u, (void *)&cy_ble_attValuesLen[25]}} },
+    { 0x002Cu, 0x2803u /* Characteristic                      */, 0x000E0001u /* rd,wwr,wr */, 0x002Eu, {{0xC900u, NULL}}                           },
+    { 0x002Du, 0xC900u /* LOGLEVEL                            */, 0x010E0101u /* rd,wwr,wr */, 0x002Eu, {{0x0008u, (void *)&cy_ble_attValuesLen[26]}} },
+    { 0x002Eu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x002Eu, {{0x000Au, (void *)&cy_ble_attValuesLen[27]}} },
+    { 0x002Fu, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x0031u, {{0xCA00u, NULL}}                           },
+    { 0x0030u, 0xCA00u /* DIAG                                */, 0x01020001u /* rd    */, 0x0031u, {{0x0079u, (void *)&cy_ble_attValuesLen[28]}} },
+    { 0x0031u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0031u, {{0x0013u, (void *)&cy_ble_attValuesLen[29]}} },
+    { 0x0032u, 0x2803u /* Characteristic                      */, 0x000E0001u /* rd,wwr,wr */, 0x0034u, {{0xCB00u, NULL}}                           },
+    { 0x0033u, 0xCB00u /* LATENCY                             */, 0x010E0101u /* rd,wwr,wr */, 0x0034u, {{0x01D4u, (void *)&cy_ble_attValuesLen[30]}} },
+    { 0x0034u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0034u, {{0x0018u, (void *)&cy_ble_attValuesLen[31]}} },
+    { 0x0035u, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x0038u, {{0xCC00u, NULL}}                           },
+    { 0x0036u, 0xCC00u /* TIMESTAMP                           */, 0x01120001u /* rd,ntf */, 0x0038u, {{0x0028u, (void *)&cy_ble_attValuesLen[32]}} },
+    { 0x0037u, 0x2902u /* Client Characteristic Configuration */, 0x030A0101u /* rd,wr */, 0x0038u, {{0x0002u, (void *)&cy_ble_attValuesLen[33]}} },
+    { 0x0038u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0038u, {{0x000Au, (void *)&cy_ble_attValuesLen[34]}} },
+    { 0x0039u, 0x2803u /* Characteristic                      */, 0x000E0001u /* rd,wwr,wr */, 0x003Bu, {{0xCD00u, NULL}}                           },
+    { 0x003Au, 0xCD00u /* DSP                                 */, 0x010E0101u /* rd,wwr,wr */, 0x003Bu, {{0x0008u, (void *)&cy_ble_attValuesLen[35]}} },
+    { 0x003Bu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x003Bu, {{0x0015u, (void *)&cy_ble_attValuesLen[36]}} },
+    { 0x003Cu, 0x2803u /* Characteristic                      */, 0x001E0001u /* rd,wwr,wr,ntf */, 0x003Fu, {{0xCE00u, NULL}}                           },
+    { 0x003Du, 0xCE00u /* FEATURES                            */, 0x011E0101u /* rd,wwr,wr,ntf */, 0x003Fu, {{0x00D9u, (void *)&cy_ble_attValuesLen[37]}} },
+    { 0x003Eu, 0x2902u /* Client Characteristic Configuration */, 0x030A0101u /* rd,wr */, 0x003Fu, {{0x0002u, (void *)&cy_ble_attValuesLen[38]}} },
+    { 0x003Fu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x003Fu, {{0x000Fu, (void *)&cy_ble_attValuesLen[39]}} },
+    { 0x0040u, 0x2803u /* Characteristic                      */, 0x000C0001u /* wwr,wr */, 0x0042u, {{0xCF00u, NULL}}                           },
+    { 0x0041u, 0xCF00u /* STEPS                               */, 0x010C0100u /* wwr,wr */, 0x0042u, {{0x0040u, (void *)&cy_ble_attValuesLen[40]}} },
+    { 0x0042u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0042u, {{0x0014u, (void *)&cy_ble_attValuesLen[41]}} },
 };
 
 #endif /* (CY_BLE_GATT_ROLE_SERVER) */
@@ -355,7 +674,7 @@ static const cy_stc_ble_params_t cy_ble_params =
     
         .siliconDeviceAddressEnabled        = 0x01u,
     
-        .gattDbIndexCount                   = 0x001Du,
+        .gattDbIndexCount                   = 0x0042u,
 };
 #endif  /* (CY_BLE_GAP_ROLE_CENTRAL || CY_BLE_GAP_ROLE_PERIPHERAL) */
 
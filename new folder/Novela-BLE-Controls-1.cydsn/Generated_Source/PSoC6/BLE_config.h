@@ -209,7 +209,7 @@ extern "C" {
 #define CY_BLE_CONFIG_ENABLE_LL_PRIVACY             (0x01u)
 
 /** LE 2 Mbps feature. */
-#define CY_BLE_CONFIG_ENABLE_PHY_UPDATE             (0u)
+#define CY_BLE_CONFIG_ENABLE_PHY_UPDATE             (1u)
 
 /** Radio power calibration. */
 #define CY_BLE_CONFIG_TX_POWER_CALIBRATION_ENABLE     (0u)      
@@ -275,11 +275,11 @@ extern "C" {
  * The valid range is from 23 to 512 bytes. 
  * This value is used to respond to an Exchange MTU request from the GATT Client.
  */
-#define CY_BLE_CONFIG_GATT_MTU                      (0x0017u)
+#define CY_BLE_CONFIG_GATT_MTU                      (0x00F7u)
 
 /** The GATT Maximum attribute length. */
-#define CY_BLE_CONFIG_GATT_DB_MAX_VALUE_LEN         (0x001Du)
-#define CY_BLE_GATT_DB_INDEX_COUNT                  (0x001Du)
+#define CY_BLE_CONFIG_GATT_DB_MAX_VALUE_LEN         (0x01D4u)
+#define CY_BLE_GATT_DB_INDEX_COUNT                  (0x0042u)
 
 /** The number of characteristics supporting the Reliable Write property. */
 #define CY_BLE_CONFIG_GATT_RELIABLE_CHAR_COUNT      (0x0000u)
@@ -310,17 +310,17 @@ extern "C" {
     #define CY_BLE_CONFIG_L2CAP_PSM_COUNT               (1u)
 #endif  /* CY_BLE_L2CAP_ENABLE != 0u */
 
-#define CY_BLE_CONFIG_GATT_DB_ATT_VAL_COUNT         (0x10u)
+#define CY_BLE_CONFIG_GATT_DB_ATT_VAL_COUNT         (0x2Au)
 
 /** Max Tx payload size. */
-#define CY_BLE_CONFIG_LL_MAX_TX_PAYLOAD_SIZE        (0x1Bu)
+#define CY_BLE_CONFIG_LL_MAX_TX_PAYLOAD_SIZE        (0xFBu)
 
 /** Max Rx payload size. */
-#define CY_BLE_CONFIG_LL_MAX_RX_PAYLOAD_SIZE        (0x1Bu)
+#define CY_BLE_CONFIG_LL_MAX_RX_PAYLOAD_SIZE        (0xFBu)
 
 /** GATT Role. */
 #define CY_BLE_CONFIG_GATT_ROLE                     (0x01u)
-#define CY_BLE_CONFIG_GATT_DB_CCCD_COUNT            (0x02u)
+#define CY_BLE_CONFIG_GATT_DB_CCCD_COUNT            (0x0Au)
 
 /** Max unique services in the project. */
 #define CY_BLE_MAX_SRVI                             (0x01u)
@@ -372,10 +372,10 @@ extern "C" {
 #define CY_BLE_CONFIG_CUSTOMC_SERVICE_COUNT         (0x00u)
 
 /** The maximum supported count of the Custom Service characteristics. */
-#define CY_BLE_CONFIG_CUSTOM_SERVICE_CHAR_COUNT     (0x05u)
+#define CY_BLE_CONFIG_CUSTOM_SERVICE_CHAR_COUNT     (0x10u)
 
 /** The maximum supported count of the Custom Service descriptors in one characteristic. */
-#define CY_BLE_CONFIG_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT  (0x01u)
+#define CY_BLE_CONFIG_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT  (0x02u)
 
 /**
  * Below are the indexes and handles of the defined Custom Services and 
@@ -392,6 +392,32 @@ extern "C" {
 #define CY_BLE_LED_OSC_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
 #define CY_BLE_LED_MISC_CHAR_INDEX   (0x04u) /* Index of MISC characteristic */
 #define CY_BLE_LED_MISC_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_STREAM_CHAR_INDEX   (0x05u) /* Index of STREAM characteristic */
+#define CY_BLE_LED_STREAM_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_INDEX   (0x00u) /* Index of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_STREAM_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_CONFIG_CHAR_INDEX   (0x06u) /* Index of CONFIG characteristic */
+#define CY_BLE_LED_CONFIG_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_STATUS_CHAR_INDEX   (0x07u) /* Index of STATUS characteristic */
+#define CY_BLE_LED_STATUS_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_INDEX   (0x00u) /* Index of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_STATUS_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_SEQ_CHAR_INDEX   (0x08u) /* Index of SEQ characteristic */
+#define CY_BLE_LED_SEQ_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_LOGLEVEL_CHAR_INDEX   (0x09u) /* Index of LOGLEVEL characteristic */
+#define CY_BLE_LED_LOGLEVEL_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_DIAG_CHAR_INDEX   (0x0Au) /* Index of DIAG characteristic */
+#define CY_BLE_LED_DIAG_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_LATENCY_CHAR_INDEX   (0x0Bu) /* Index of LATENCY characteristic */
+#define CY_BLE_LED_LATENCY_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_TIMESTAMP_CHAR_INDEX   (0x0Cu) /* Index of TIMESTAMP characteristic */
+#define CY_BLE_LED_TIMESTAMP_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_INDEX   (0x00u) /* Index of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_TIMESTAMP_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_DSP_CHAR_INDEX   (0x0Du) /* Index of DSP characteristic */
+#define CY_BLE_LED_DSP_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_FEATURES_CHAR_INDEX   (0x0Eu) /* Index of FEATURES characteristic */
+#define CY_BLE_LED_FEATURES_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_INDEX   (0x00u) /* Index of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_FEATURES_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CY_BLE_LED_STEPS_CHAR_INDEX   (0x0Fu) /* Index of STEPS characteristic */
+#define CY_BLE_LED_STEPS_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
 
 
 #define CY_BLE_LED_SERVICE_HANDLE   (0x000Eu) /* Handle of LED service */
@@ -410,6 +436,43 @@ extern "C" {
 #define CY_BLE_LED_MISC_DECL_HANDLE   (0x001Bu) /* Handle of MISC characteristic declaration */
 #define CY_BLE_LED_MISC_CHAR_HANDLE   (0x001Cu) /* Handle of MISC characteristic */
 #define CY_BLE_LED_MISC_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x001Du) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_STREAM_DECL_HANDLE   (0x001Eu) /* Handle of STREAM characteristic declaration */
+#define CY_BLE_LED_STREAM_CHAR_HANDLE   (0x001Fu) /* Handle of STREAM characteristic */
+#define CY_BLE_LED_STREAM_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE   (0x0020u) /* Handle of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_STREAM_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0021u) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_CONFIG_DECL_HANDLE   (0x0022u) /* Handle of CONFIG characteristic declaration */
+#define CY_BLE_LED_CONFIG_CHAR_HANDLE   (0x0023u) /* Handle of CONFIG characteristic */
+#define CY_BLE_LED_CONFIG_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0024u) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_STATUS_DECL_HANDLE   (0x0025u) /* Handle of STATUS characteristic declaration */
+#define CY_BLE_LED_STATUS_CHAR_HANDLE   (0x0026u) /* Handle of STATUS characteristic */
+#define CY_BLE_LED_STATUS_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE   (0x0027u) /* Handle of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_STATUS_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0028u) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_SEQ_DECL_HANDLE   (0x0029u) /* Handle of SEQ characteristic declaration */
+#define CY_BLE_LED_SEQ_CHAR_HANDLE   (0x002Au) /* Handle of SEQ characteristic */
+#define CY_BLE_LED_SEQ_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x002Bu) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_LOGLEVEL_DECL_HANDLE   (0x002Cu) /* Handle of LOGLEVEL characteristic declaration */
+#define CY_BLE_LED_LOGLEVEL_CHAR_HANDLE   (0x002Du) /* Handle of LOGLEVEL characteristic */
+#define CY_BLE_LED_LOGLEVEL_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x002Eu) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_DIAG_DECL_HANDLE   (0x002Fu) /* Handle of DIAG characteristic declaration */
+#define CY_BLE_LED_DIAG_CHAR_HANDLE   (0x0030u) /* Handle of DIAG characteristic */
+#define CY_BLE_LED_DIAG_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0031u) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_LATENCY_DECL_HANDLE   (0x0032u) /* Handle of LATENCY characteristic declaration */
+#define CY_BLE_LED_LATENCY_CHAR_HANDLE   (0x0033u) /* Handle of LATENCY characteristic */
+#define CY_BLE_LED_LATENCY_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0034u) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_TIMESTAMP_DECL_HANDLE   (0x0035u) /* Handle of TIMESTAMP characteristic declaration */
+#define CY_BLE_LED_TIMESTAMP_CHAR_HANDLE   (0x0036u) /* Handle of TIMESTAMP characteristic */
+#define CY_BLE_LED_TIMESTAMP_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE   (0x0037u) /* Handle of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_TIMESTAMP_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0038u) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_DSP_DECL_HANDLE   (0x0039u) /* Handle of DSP characteristic declaration */
+#define CY_BLE_LED_DSP_CHAR_HANDLE   (0x003Au) /* Handle of DSP characteristic */
+#define CY_BLE_LED_DSP_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x003Bu) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_FEATURES_DECL_HANDLE   (0x003Cu) /* Handle of FEATURES characteristic declaration */
+#define CY_BLE_LED_FEATURES_CHAR_HANDLE   (0x003Du) /* Handle of FEATURES characteristic */
+#define CY_BLE_LED_FEATURES_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE   (0x003Eu) /* Handle of Client Characteristic Configuration descriptor */
+#define CY_BLE_LED_FEATURES_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x003Fu) /* Handle of Characteristic User Description descriptor */
+#define CY_BLE_LED_STEPS_DECL_HANDLE   (0x0040u) /* Handle of STEPS characteristic declaration */
+#define CY_BLE_LED_STEPS_CHAR_HANDLE   (0x0041u) /* Handle of STEPS characteristic */
+#define CY_BLE_LED_STEPS_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0042u) /* Handle of Characteristic User Description descriptor */
 
 
 
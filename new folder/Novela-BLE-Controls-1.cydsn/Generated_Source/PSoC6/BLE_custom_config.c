@@ -81,6 +81,120 @@ static const cy_stc_ble_customs_t cy_ble_customs[0x01u] = {
                     0x001Du, /* Handle of the Characteristic User Description descriptor */ 
                 }, 
             },
+
+            /* STREAM characteristic */
+            {
+                0x001Fu, /* Handle of the STREAM characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0020u, /* Handle of the Client Characteristic Configuration descriptor */ 
+                    0x0021u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* CONFIG characteristic */
+            {
+                0x0023u, /* Handle of the CONFIG characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0024u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* STATUS characteristic */
+            {
+                0x0026u, /* Handle of the STATUS characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0027u, /* Handle of the Client Characteristic Configuration descriptor */ 
+                    0x0028u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* SEQ characteristic */
+            {
+                0x002Au, /* Handle of the SEQ characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x002Bu, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* LOGLEVEL characteristic */
+            {
+                0x002Du, /* Handle of the LOGLEVEL characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x002Eu, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* DIAG characteristic */
+            {
+                0x0030u, /* Handle of the DIAG characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0031u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* LATENCY characteristic */
+            {
+                0x0033u, /* Handle of the LATENCY characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0034u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* TIMESTAMP characteristic */
+            {
+                0x0036u, /* Handle of the TIMESTAMP characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0037u, /* Handle of the Client Characteristic Configuration descriptor */ 
+                    0x0038u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* DSP characteristic */
+            {
+                0x003Au, /* Handle of the DSP characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x003Bu, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* FEATURES characteristic */
+            {
+                0x003Du, /* Handle of the FEATURES characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x003Eu, /* Handle of the Client Characteristic Configuration descriptor */ 
+                    0x003Fu, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* STEPS characteristic */
+            {
+                0x0041u, /* Handle of the STEPS characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0042u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
         }, 
     },
 };
@@ -0,0 +1,257 @@
+/*******************************************************************************
+* File Name: acq.c
+*
+* Version: 1.20
+*
+* Description:
+*   External ADC acquisition, see acq.h.
+*   The I2C ISR is the only producer of acqRing and the BLE task the only
+*   consumer. Starting, stopping and retrying run in the BLE task; while
+*   the chain runs, only the ISR touches the bus.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "acq.h"
+#include "ringbuf.h"
+#include "seq.h"
+#include "ts.h"
+#include "log.h"
+#include "task.h"
+
+/*********************************************************************
+* I2C master configuration                                           *
+**********************************************************************/
+static const cy_stc_scb_i2c_config_t acqI2cConfig =
+{
+    .i2cMode             = CY_SCB_I2C_MASTER,
+    .useRxFifo           = false,
+    .useTxFifo           = false,
+    .slaveAddress        = 0u,
+    .slaveAddressMask    = 0u,
+    .acceptAddrInFifo    = false,
+    .ackGeneralAddr      = false,
+    .enableWakeFromSleep = false,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   acqRx, acqSum and acqReads belong to the ISR while the chain     *
+*   runs                                                             *
+**********************************************************************/
+static stream_sample_t  acqStorage[ACQ_RING_DEPTH];
+static ringbuf_t        acqRing;
+static volatile uint32_t acqDropped = 0u;       /* ISR owned */
+
+static uint8_t          acqRx[ACQ_ADC_BYTES];
+static cy_stc_scb_i2c_master_xfer_config_t acqXfer =
+{
+    .slaveAddress = ACQ_ADC_ADDR,
+    .buffer       = acqRx,
+    .bufferSize   = ACQ_ADC_BYTES,
+    .xferPending  = false,
+};
+static uint32_t         acqSum = 0u;
+static uint32_t         acqReads = 0u;
+
+static volatile bool    acqRunning = false;
+static volatile bool    acqStopping = false;
+static volatile bool    acqFailed = false;
+static bool             acqReported = false;    /* until the next sample */
+static TickType_t       acqRetryTick = 0u;
+
+/*******************************************************************************
+* Function: Acq_Read
+* Input:    void
+* Return:   true if the next read was started
+*******************************************************************************/
+static bool Acq_Read(void)
+{
+    return Cy_SCB_I2C_MasterRead(I2C_HW, &acqXfer, &I2C_context) == CY_SCB_I2C_SUCCESS;
+}
+
+/*******************************************************************************
+* Function: Acq_Event
+* Input:    event - CY_SCB_I2C_MASTER_* event flags
+* Return:   void
+* Description:
+*    I2C completion callback, runs in the I2C ISR. Takes the result and
+*    starts the next read right away.
+*******************************************************************************/
+static void Acq_Event(uint32_t event)
+{
+    stream_sample_t s;
+
+    if((event & CY_SCB_I2C_MASTER_ERR_EVENT) != 0u)
+    {
+        acqFailed  = true;
+        acqRunning = false;
+        return;
+    }
+    if((event & CY_SCB_I2C_MASTER_RD_CMPLT_EVENT) == 0u)
+    {
+        return;
+    }
+
+    acqSum += (((uint32_t)acqRx[0] << 8u) | acqRx[1]) & ACQ_ADC_MASK;
+    if(++acqReads >= ACQ_AVERAGE)
+    {
+        s.time     = Ts_Now();  /* end of the last read */
+        s.value    = (uint16_t)(acqSum / ACQ_AVERAGE);
+        s.channel  = (uint8_t)Seq_GetChannel();
+        s.reserved = 0u;
+        if(!RingBuf_Put(&acqRing, &s))
+        {
+            acqDropped++;
+        }
+        acqSum   = 0u;
+        acqReads = 0u;
+    }
+
+    if(acqStopping || !Acq_Read())
+    {
+        acqRunning = false;
+    }
+}
+
+/*******************************************************************************
+* Function: Acq_Start
+* Input:    void
+* Return:   void
+* Description:
+*    Starts the read chain with an empty ring. BLE task, chain stopped.
+*******************************************************************************/
+static void Acq_Start(void)
+{
+    RingBuf_Reset(&acqRing);
+    acqSum      = 0u;
+    acqReads    = 0u;
+    acqFailed   = false;
+    acqStopping = false;
+
+    acqRunning = true;
+    if(!Acq_Read())
+    {
+        acqFailed  = true;
+        acqRunning = false;
+    }
+}
+
+/*******************************************************************************
+* Function: Acq_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Sets SCB6 up as the I2C master and hooks its interrupt. The bus stays
+*    idle until Acq_Process() is asked to run. Call before the scheduler.
+*******************************************************************************/
+void Acq_Init(void)
+{
+    RingBuf_Init(&acqRing, acqStorage, sizeof(stream_sample_t), ACQ_RING_DEPTH);
+
+    (void)Cy_SysClk_PeriphSetDivider(I2C_SCBCLK__DIV_TYPE, I2C_SCBCLK__DIV_NUM, ACQ_CLOCK_DIVIDER);
+
+    (void)Cy_SCB_I2C_Init(I2C_HW, &acqI2cConfig, &I2C_context);
+    (void)Cy_SCB_I2C_SetDataRate(I2C_HW, ACQ_DATA_RATE_HZ, Cy_SysClk_PeriphGetFrequency(
+                                 I2C_SCBCLK__DIV_TYPE, I2C_SCBCLK__DIV_NUM));
+    Cy_SCB_I2C_RegisterEventCallback(I2C_HW, &Acq_Event, &I2C_context);
+
+    (void)Cy_SysInt_Init(&I2C_SCB_IRQ_cfg, &I2C_Interrupt);
+    NVIC_EnableIRQ((IRQn_Type)I2C_SCB_IRQ_cfg.intrSrc);
+
+    Cy_SCB_I2C_Enable(I2C_HW);
+}
+
+/*******************************************************************************
+* Function: Acq_Process
+* Input:    wanted - whether samples are needed now
+* Return:   ticks until the next retry, portMAX_DELAY if none is due
+* Description:
+*    Called from the BLE task loop. Starts the chain when samples are
+*    wanted, lets it stop at the end of the current read when they are not,
+*    and retries after a bus error.
+*******************************************************************************/
+TickType_t Acq_Process(bool wanted)
+{
+    TickType_t now = xTaskGetTickCount();
+
+    if(!wanted)
+    {
+        acqStopping = true;
+        return portMAX_DELAY;
+    }
+    acqStopping = false;
+    if(acqRunning)
+    {
+        return portMAX_DELAY;
+    }
+
+    if(acqFailed)
+    {
+        if(!acqReported)
+        {
+            LOG_WRN("acq: no answer from the ADC at 0x%02x\r\n", (unsigned)ACQ_ADC_ADDR);
+            acqReported  = true;
+            acqRetryTick = now;
+        }
+        if((now - acqRetryTick) < pdMS_TO_TICKS(ACQ_RETRY_MS))
+        {
+            return pdMS_TO_TICKS(ACQ_RETRY_MS) - (now - acqRetryTick);
+        }
+        acqRetryTick = now;
+    }
+
+    Acq_Start();
+    return acqFailed ? pdMS_TO_TICKS(ACQ_RETRY_MS) : portMAX_DELAY;
+}
+
+/*******************************************************************************
+* Function: Acq_IsRunning
+* Input:    void
+* Return:   true while a read chain is on the bus
+*******************************************************************************/
+bool Acq_IsRunning(void)
+{
+    return acqRunning;
+}
+
+/*******************************************************************************
+* Function: Acq_Get
+* Input:    sample - destination
+* Return:   true if a sample was copied out, false if the ring was empty
+* Description:
+*    Consumer side, BLE task only. A sample re-arms the failure log.
+*******************************************************************************/
+bool Acq_Get(stream_sample_t *sample)
+{
+    if(!RingBuf_Get(&acqRing, sample))
+    {
+        return false;
+    }
+    acqReported = false;
+    return true;
+}
+
+/*******************************************************************************
+* Function: Acq_TakeDropped
+* Input:    void
+* Return:   samples lost to a full ring since the last call
+*******************************************************************************/
+uint32_t Acq_TakeDropped(void)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    uint32_t dropped = acqDropped;
+
+    acqDropped = 0u;
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    return dropped;
+}
+
+/* [] END OF FILE */
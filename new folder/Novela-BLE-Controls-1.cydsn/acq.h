@@ -0,0 +1,69 @@
+/*******************************************************************************
+* File Name: acq.h
+*
+* Version: 1.20
+*
+* Description:
+*   Sample acquisition from the external ADC on the I2C bus (SCB6).
+*   Each read of the ADC returns a fresh conversion (MCP3221 style, no
+*   register pointer), so the engine chains master reads from the I2C
+*   completion callback and the CPU never polls the bus. ACQ_AVERAGE reads
+*   are averaged into one sample, stamped with the current MUX channel and
+*   the time base of ts.h, and queued in a ring that Stream_Process()
+*   drains into the STREAM ring.
+*
+*   At 400 kHz one read takes about 75 us, so the sample rate is about
+*   13 kHz / ACQ_AVERAGE.
+*
+*   The engine only runs while a client listens on STREAM; Acq_Process()
+*   starts and stops it. A bus error stops the chain and the BLE task
+*   retries after ACQ_RETRY_MS, so a missing ADC costs one transfer per
+*   retry.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef ACQ_H
+
+    #define ACQ_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "FreeRTOS.h"
+    #include "stream.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define ACQ_ADC_ADDR                (0x4Du) /* 7 bit, MCP3221A5             */
+    #define ACQ_ADC_BYTES               (2u)    /* big endian result            */
+    #define ACQ_ADC_MASK                (0x0FFFu)
+    #define ACQ_AVERAGE                 (4u)    /* reads per sample             */
+    #define ACQ_RING_DEPTH              (256u)  /* samples, power of two        */
+    #define ACQ_RETRY_MS                (1000u)
+
+    /* The I2C component in TopDesign is a slave, and its 12.5 MHz clock
+       fits no master data rate, so SCB6 is set up here as a master with
+       its own divider */
+    #define ACQ_DATA_RATE_HZ            (400000u)
+    #define ACQ_CLOCK_DIVIDER           (5u)    /* clk_peri 50 MHz / 6 = 8.3 MHz */
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void       Acq_Init(void);
+    TickType_t Acq_Process(bool wanted);
+    bool       Acq_IsRunning(void);
+    bool       Acq_Get(stream_sample_t *sample);
+    uint32_t   Acq_TakeDropped(void);
+
+#endif
+
+/* [] END OF FILE */
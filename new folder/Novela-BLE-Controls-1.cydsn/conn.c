@@ -0,0 +1,435 @@
+/*******************************************************************************
+* File Name: conn.c
+*
+* Version: 1.20
+*
+* Description:
+*   Tracks the ATT MTU and LE Data Length Extension values of each connection.
+*   As a GATT server the probe cannot start the MTU exchange itself, so it
+*   answers the client's request with CY_BLE_GATT_MTU (247) and asks the
+*   controller for the largest data length right after the connection opens.
+*
+*   Conn_Process() compares what the link is doing with the policy table and
+*   asks the central for new connection parameters (L2CAP connection
+*   parameter update) and the PHY when the mode changes. Only one request of
+*   each kind is outstanding at a time; a rejected request is not repeated
+*   until the mode changes again.
+*   All functions run in the BLE task.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#define LOG_MODULE CONN
+
+#include "conn.h"
+#include "task.h"
+#include "log.h"
+#include <stdio.h>
+
+/*********************************************************************
+* Connection policy                                                  *
+*   Intervals follow the Apple accessory guidelines so phones accept *
+*   them: min >= 15 ms, max >= min + 15 ms, max * (latency + 1) < 2s *
+**********************************************************************/
+static const conn_policy_t connPolicy[CONN_MODE_COUNT] =
+{
+    /*                  intvMin  intvMax  latency  timeout  PHY                    */
+    /* IDLE   */      {   80u,    160u,     4u,     600u,   CY_BLE_PHY_MASK_LE_1M  }, /* 100-200 ms, 6 s */
+    /* CONFIG */      {   12u,     24u,     0u,     200u,   CY_BLE_PHY_MASK_LE_2M  }, /*  15-30 ms,  2 s */
+    /* STREAM */      {   12u,     24u,     0u,     200u,   CY_BLE_PHY_MASK_LE_2M  }, /*  15-30 ms,  2 s */
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+static conn_info_t connInfo[CY_BLE_CONN_COUNT];
+
+/*******************************************************************************
+* Function: Conn_FindByBdHandle
+* Input:    bdHandle - peer device handle from a GAP/L2CAP event
+* Return:   connection using that peer, NULL if none
+*******************************************************************************/
+static conn_info_t *Conn_FindByBdHandle(uint8_t bdHandle)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(connInfo[i].connected && (connInfo[i].connHandle.bdHandle == bdHandle))
+        {
+            return &connInfo[i];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function: Conn_ApplyPolicy
+* Input:    conn - connection
+*           mode - policy to switch to
+* Return:   void
+* Description:
+*    Requests the connection parameters and PHY of the policy. Parameters
+*    already in range are not requested again.
+*******************************************************************************/
+static void Conn_ApplyPolicy(conn_info_t *conn, conn_mode_t mode)
+{
+    const conn_policy_t *policy = &connPolicy[mode];
+    cy_stc_ble_gap_conn_update_param_info_t paramInfo;
+    cy_stc_ble_set_phy_info_t phyInfo;
+    cy_en_ble_api_result_t apiResult;
+
+    conn->mode = mode;
+
+    if((conn->interval < policy->intervalMin) || (conn->interval > policy->intervalMax) ||
+       (conn->latency != policy->latency))
+    {
+        paramInfo.connIntvMin   = policy->intervalMin;
+        paramInfo.connIntvMax   = policy->intervalMax;
+        paramInfo.connLatency   = policy->latency;
+        paramInfo.supervisionTO = policy->timeout;
+        paramInfo.bdHandle      = conn->connHandle.bdHandle;
+        paramInfo.ceLength      = 0u;
+
+        apiResult = Cy_BLE_L2CAP_LeConnectionParamUpdateRequest(&paramInfo);
+        conn->paramPending = (apiResult == CY_BLE_SUCCESS);
+        if(apiResult != CY_BLE_SUCCESS)
+        {
+            LOG_WRN("Conn param update error: %x \r\n", apiResult);
+        }
+    }
+
+    if((conn->txPhy != policy->phy) || (conn->rxPhy != policy->phy))
+    {
+        phyInfo.bdHandle   = conn->connHandle.bdHandle;
+        phyInfo.allPhyMask = CY_BLE_PHY_NO_PREF_MASK_NONE;
+        phyInfo.txPhyMask  = policy->phy;
+        phyInfo.rxPhyMask  = policy->phy;
+        phyInfo.phyOption  = 0u;
+
+        apiResult = Cy_BLE_SetPhy(&phyInfo);
+        conn->phyPending = (apiResult == CY_BLE_SUCCESS);
+        if(apiResult != CY_BLE_SUCCESS)
+        {
+            LOG_WRN("Cy_BLE_SetPhy error: %x \r\n", apiResult);
+        }
+    }
+
+    LOG_INF("Conn policy: %d \r\n", mode);
+}
+
+/*******************************************************************************
+* Function: Conn_Open
+* Input:    connHandle - handle from CY_BLE_EVT_GATT_CONNECT_IND
+* Return:   void
+* Description:
+*    Starts the connection at the Bluetooth defaults and requests the largest
+*    LL payload. The result arrives as CY_BLE_EVT_DATA_LENGTH_CHANGE.
+*******************************************************************************/
+void Conn_Open(cy_stc_ble_conn_handle_t connHandle)
+{
+    conn_info_t *conn;
+    cy_en_ble_api_result_t apiResult;
+    cy_stc_ble_set_data_length_info_t dleParam;
+
+    if(connHandle.attId >= CY_BLE_CONN_COUNT)
+    {
+        return;
+    }
+
+    conn = &connInfo[connHandle.attId];
+    conn->connHandle = connHandle;
+    conn->connected  = true;
+    conn->mtu        = CY_BLE_GATT_DEFAULT_MTU;
+    conn->txOctets   = CY_BLE_LL_MIN_SUPPORTED_TX_PAYLOAD_SIZE;
+    conn->rxOctets   = CY_BLE_LL_MIN_SUPPORTED_RX_PAYLOAD_SIZE;
+    conn->txTime     = CONN_LL_DEFAULT_TIME;
+    conn->rxTime     = CONN_LL_DEFAULT_TIME;
+    conn->interval   = 0u;
+    conn->latency    = 0u;
+    conn->timeout    = 0u;
+    conn->txPhy      = CY_BLE_PHY_MASK_LE_1M;
+    conn->rxPhy      = CY_BLE_PHY_MASK_LE_1M;
+    conn->paramPending = false;
+    conn->phyPending   = false;
+
+    /* The client discovers and configures right after connecting, so the
+       first Conn_Process() asks for the CONFIG policy; the link relaxes to
+       IDLE once it goes quiet */
+    conn->mode       = CONN_MODE_IDLE;
+    conn->lastConfig = xTaskGetTickCount();
+
+    dleParam.bdHandle        = connHandle.bdHandle;
+    dleParam.connMaxTxOctets = CY_BLE_LL_MAX_TX_PAYLOAD_SIZE;
+    dleParam.connMaxTxTime   = CY_BLE_LL_MAX_TX_TIME;
+    dleParam.connMaxRxOctets = CY_BLE_LL_MAX_RX_PAYLOAD_SIZE;
+    dleParam.connMaxRxTime   = CY_BLE_LL_MAX_TX_TIME;
+
+    apiResult = Cy_BLE_SetDataLength(&dleParam);
+    if(apiResult != CY_BLE_SUCCESS)
+    {
+        LOG_WRN("Cy_BLE_SetDataLength error: %x \r\n", apiResult);
+    }
+}
+
+/*******************************************************************************
+* Function: Conn_Close
+* Input:    connHandle - handle of the connection that went away
+* Return:   void
+*******************************************************************************/
+void Conn_Close(cy_stc_ble_conn_handle_t connHandle)
+{
+    if(connHandle.attId < CY_BLE_CONN_COUNT)
+    {
+        connInfo[connHandle.attId].connected = false;
+    }
+}
+
+/*******************************************************************************
+* Function: Conn_MtuExchanged
+* Input:    mtuParam - parameter of CY_BLE_EVT_GATTS_XCNHG_MTU_REQ
+* Return:   void
+* Description:
+*    The stack has already answered with CY_BLE_GATT_MTU, so the MTU in use
+*    is the smaller of the two.
+*******************************************************************************/
+void Conn_MtuExchanged(const cy_stc_ble_gatt_xchg_mtu_param_t *mtuParam)
+{
+    conn_info_t *conn;
+
+    if(mtuParam->connHandle.attId >= CY_BLE_CONN_COUNT)
+    {
+        return;
+    }
+
+    conn = &connInfo[mtuParam->connHandle.attId];
+    conn->mtu = (mtuParam->mtu < CY_BLE_GATT_MTU) ? mtuParam->mtu : CY_BLE_GATT_MTU;
+    if(conn->mtu < CY_BLE_GATT_DEFAULT_MTU)
+    {
+        conn->mtu = CY_BLE_GATT_DEFAULT_MTU;
+    }
+
+    LOG_INF("ATT MTU: %d (client %d) \r\n", conn->mtu, mtuParam->mtu);
+}
+
+/*******************************************************************************
+* Function: Conn_DataLengthChanged
+* Input:    dleParam - parameter of CY_BLE_EVT_DATA_LENGTH_CHANGE
+* Return:   void
+*******************************************************************************/
+void Conn_DataLengthChanged(const cy_stc_ble_data_length_change_event_param_t *dleParam)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(connInfo[i].connected && (connInfo[i].connHandle.bdHandle == dleParam->bdHandle))
+        {
+            connInfo[i].txOctets = dleParam->connMaxTxOctets;
+            connInfo[i].txTime   = dleParam->connMaxTxTime;
+            connInfo[i].rxOctets = dleParam->connMaxRxOctets;
+            connInfo[i].rxTime   = dleParam->connMaxRxTime;
+        }
+    }
+
+    LOG_INF("LL data length: tx %d/%dus rx %d/%dus \r\n",
+           dleParam->connMaxTxOctets, dleParam->connMaxTxTime,
+           dleParam->connMaxRxOctets, dleParam->connMaxRxTime);
+}
+
+/*******************************************************************************
+* Function: Conn_ParamUpdated
+* Input:    param - parameter of CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE
+* Return:   void
+*******************************************************************************/
+void Conn_ParamUpdated(const cy_stc_ble_gap_conn_param_updated_in_controller_t *param)
+{
+    conn_info_t *conn = Conn_FindByBdHandle(param->bdHandle);
+
+    if((conn != NULL) && (param->status == 0u))
+    {
+        conn->interval = param->connIntv;
+        conn->latency  = param->connLatency;
+        conn->timeout  = param->supervisionTO;
+        conn->paramPending = false;
+    }
+
+    LOG_INF("Conn params: status %x interval %d latency %d timeout %d \r\n",
+           param->status, param->connIntv, param->connLatency, param->supervisionTO);
+}
+
+/*******************************************************************************
+* Function: Conn_ParamResponse
+* Input:    param - parameter of CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP
+* Return:   void
+* Description:
+*    When the central accepts, the new parameters follow in
+*    CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE.
+*******************************************************************************/
+void Conn_ParamResponse(const cy_stc_ble_l2cap_conn_update_rsp_param_t *param)
+{
+    conn_info_t *conn = Conn_FindByBdHandle(param->bdHandle);
+
+    if((conn != NULL) && (param->result != 0u))
+    {
+        conn->paramPending = false;
+        LOG_WRN("Conn param update rejected \r\n");
+    }
+}
+
+/*******************************************************************************
+* Function: Conn_PhyUpdated
+* Input:    param - parameter of CY_BLE_EVT_PHY_UPDATE_COMPLETE or
+*                   CY_BLE_EVT_SET_PHY_COMPLETE
+* Return:   void
+* Description:
+*    A failed Cy_BLE_SetPhy() only reports CY_BLE_EVT_SET_PHY_COMPLETE, a
+*    successful one ends with CY_BLE_EVT_PHY_UPDATE_COMPLETE.
+*******************************************************************************/
+void Conn_PhyUpdated(const cy_stc_ble_events_param_generic_t *param)
+{
+    const cy_stc_ble_phy_param_t *phy = (const cy_stc_ble_phy_param_t *)param->eventParams;
+    conn_info_t *conn;
+    uint32_t i;
+
+    if(param->status != 0u)
+    {
+        /* Peer without LE 2M: stay on what we have */
+        for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+        {
+            connInfo[i].phyPending = false;
+        }
+        LOG_WRN("PHY update failed: %x \r\n", param->status);
+        return;
+    }
+
+    if(phy == NULL)
+    {
+        return;
+    }
+
+    conn = Conn_FindByBdHandle(phy->bdHandle);
+    if(conn != NULL)
+    {
+        conn->txPhy = phy->txPhyMask;
+        conn->rxPhy = phy->rxPhyMask;
+        conn->phyPending = false;
+    }
+
+    LOG_INF("PHY: tx %d rx %d \r\n", phy->txPhyMask, phy->rxPhyMask);
+}
+
+/*******************************************************************************
+* Function: Conn_NoteConfig
+* Input:    connHandle - connection that received a control write
+* Return:   void
+* Description:
+*    Keeps the link in the CONFIG policy for another CONN_CONFIG_HOLD_MS
+*******************************************************************************/
+void Conn_NoteConfig(cy_stc_ble_conn_handle_t connHandle)
+{
+    if(connHandle.attId < CY_BLE_CONN_COUNT)
+    {
+        connInfo[connHandle.attId].lastConfig = xTaskGetTickCount();
+    }
+}
+
+/*******************************************************************************
+* Function: Conn_Process
+* Input:    streaming - a client is receiving STREAM notifications
+* Return:   ticks until Conn_Process() has to run again
+* Description:
+*    Called from the BLE task loop. Picks the policy for each connection
+*    and requests it when it changed.
+*******************************************************************************/
+TickType_t Conn_Process(bool streaming)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t hold = pdMS_TO_TICKS(CONN_CONFIG_HOLD_MS);
+    TickType_t wait = portMAX_DELAY;
+    TickType_t age;
+    conn_info_t *conn;
+    conn_mode_t mode;
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        conn = &connInfo[i];
+        if(!conn->connected)
+        {
+            continue;
+        }
+
+        age = now - conn->lastConfig;
+        if(streaming)
+        {
+            mode = CONN_MODE_STREAM;
+        }
+        else if(age < hold)
+        {
+            mode = CONN_MODE_CONFIG;
+            if((hold - age) < wait)
+            {
+                wait = hold - age;
+            }
+        }
+        else
+        {
+            mode = CONN_MODE_IDLE;
+        }
+
+        if((mode != conn->mode) && !conn->paramPending && !conn->phyPending)
+        {
+            Conn_ApplyPolicy(conn, mode);
+        }
+    }
+
+    return wait;
+}
+
+/*******************************************************************************
+* Function: Conn_GetPayload
+* Input:    attId - connection
+* Return:   bytes of value that fit in one notification
+* Description:
+*    MTU - 3. When the link layer PDUs are shorter than the L2CAP frame, the
+*    payload is trimmed so the frame ends on a PDU boundary instead of
+*    spending a whole connection-event slot on a few trailing bytes.
+*******************************************************************************/
+uint16_t Conn_GetPayload(uint8_t attId)
+{
+    const conn_info_t *conn;
+    uint32_t frame;
+
+    if((attId >= CY_BLE_CONN_COUNT) || !connInfo[attId].connected)
+    {
+        return CY_BLE_GATT_DEFAULT_MTU - CONN_ATT_HEADER_SIZE;
+    }
+
+    conn  = &connInfo[attId];
+    frame = (uint32_t)conn->mtu + CONN_L2CAP_HEADER_SIZE;
+    if(frame > conn->txOctets)
+    {
+        frame = (frame / conn->txOctets) * conn->txOctets;
+    }
+
+    return (uint16_t)(frame - CONN_L2CAP_HEADER_SIZE - CONN_ATT_HEADER_SIZE);
+}
+
+/*******************************************************************************
+* Function: Conn_Get
+* Input:    attId - connection
+* Return:   link state of the connection, NULL if attId is out of range
+*******************************************************************************/
+const conn_info_t *Conn_Get(uint8_t attId)
+{
+    return (attId < CY_BLE_CONN_COUNT) ? &connInfo[attId] : NULL;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* File Name: conn.h
+*
+* Version: 1.20
+*
+* Description:
+*   Per-connection link state: negotiated ATT MTU and LE data length.
+*   Outgoing notifications are sized from here instead of the 23 byte default.
+*   A small policy table picks the PHY and connection parameters for what
+*   the link is doing: streaming, being configured, or idle.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CONN_H
+
+    #define CONN_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "FreeRTOS.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define CONN_L2CAP_HEADER_SIZE      (4u)    /* L2CAP length + CID           */
+    #define CONN_ATT_HEADER_SIZE        (3u)    /* notification opcode + handle */
+    #define CONN_LL_DEFAULT_TIME        (328u)  /* us, 27 byte PDU on LE 1M     */
+
+    /* The link counts as being configured for this long after the last
+       control write (and after connecting, while the client discovers) */
+    #define CONN_CONFIG_HOLD_MS         (3000u)
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef enum
+    {
+        CONN_MODE_IDLE = 0u,
+        CONN_MODE_CONFIG,
+        CONN_MODE_STREAM,
+        CONN_MODE_COUNT
+    } conn_mode_t;
+
+    typedef struct
+    {
+        uint16_t             intervalMin;   /* 1.25 ms units */
+        uint16_t             intervalMax;   /* 1.25 ms units */
+        uint16_t             latency;       /* events        */
+        uint16_t             timeout;       /* 10 ms units   */
+        cy_en_ble_phy_mask_t phy;
+    } conn_policy_t;
+
+    typedef struct
+    {
+        cy_stc_ble_conn_handle_t connHandle;
+        bool                     connected;
+        uint16_t                 mtu;           /* effective ATT MTU          */
+        uint16_t                 txOctets;      /* LL payload, local -> peer  */
+        uint16_t                 txTime;        /* us                         */
+        uint16_t                 rxOctets;      /* LL payload, peer -> local  */
+        uint16_t                 rxTime;        /* us                         */
+        uint16_t                 interval;      /* 1.25 ms units              */
+        uint16_t                 latency;
+        uint16_t                 timeout;       /* 10 ms units                */
+        cy_en_ble_phy_mask_t     txPhy;
+        cy_en_ble_phy_mask_t     rxPhy;
+        conn_mode_t              mode;          /* last policy requested      */
+        bool                     paramPending;
+        bool                     phyPending;
+        TickType_t               lastConfig;
+    } conn_info_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void               Conn_Open(cy_stc_ble_conn_handle_t connHandle);
+    void               Conn_Close(cy_stc_ble_conn_handle_t connHandle);
+    void               Conn_MtuExchanged(const cy_stc_ble_gatt_xchg_mtu_param_t *mtuParam);
+    void               Conn_DataLengthChanged(const cy_stc_ble_data_length_change_event_param_t *dleParam);
+    void               Conn_ParamUpdated(const cy_stc_ble_gap_conn_param_updated_in_controller_t *param);
+    void               Conn_ParamResponse(const cy_stc_ble_l2cap_conn_update_rsp_param_t *param);
+    void               Conn_PhyUpdated(const cy_stc_ble_events_param_generic_t *param);
+    void               Conn_NoteConfig(cy_stc_ble_conn_handle_t connHandle);
+    TickType_t         Conn_Process(bool streaming);
+    uint16_t           Conn_GetPayload(uint8_t attId);
+    const conn_info_t *Conn_Get(uint8_t attId);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,250 @@
+/*******************************************************************************
+* File Name: control.c
+*
+* Version: 1.20
+*
+* Description:
+*   Control task and its command queue, see control.h.
+*   Control_Post() never blocks: when the queue is full the command is
+*   refused and the BLE task reports the write as failed to the client.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#define LOG_MODULE CTRL
+
+#include "control.h"
+#include "log.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <string.h>
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+static QueueHandle_t     controlQueue = NULL;
+static volatile uint32_t controlRejected = 0u;
+static TaskHandle_t      controlTask = NULL;
+static rpc_msg_t         controlReply;      /* written by the RPC done callback */
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+static uint8_t           controlQueueStorage[CONTROL_QUEUE_DEPTH * sizeof(control_cmd_t)];
+static StaticQueue_t     controlQueueBuffer;
+static StackType_t       controlTaskStack[CONTROL_TASK_STACK];
+static StaticTask_t      controlTaskTcb;
+#endif
+
+/*******************************************************************************
+* Function: Control_StepsDone
+* Input:    reply   - RPC_OP_STEPS reply
+*           context - unused
+* Return:   void
+* Description:
+*    RPC done callback, in the CM4 pipe ISR. Wakes the control task.
+*******************************************************************************/
+static void Control_StepsDone(const rpc_msg_t *reply, void *context)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)context;
+
+    controlReply = *reply;
+    vTaskNotifyGiveFromISR(controlTask, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/*******************************************************************************
+* Function: Control_Steps
+* Input:    cmd - CONTROL_CMD_STEPS, already validated
+* Return:   void
+* Description:
+*    Lends the front end ports to the CM0+ for the steps. The sweep is
+*    stopped first, then the task blocks until the reply, so nothing on
+*    the CM4 writes the ports while the CM0+ does. There is no time out:
+*    going on without the reply would hand the ports back too early.
+*******************************************************************************/
+static void Control_Steps(const control_cmd_t *cmd)
+{
+    rpc_msg_t request;
+
+    Seq_Stop();
+
+    memset(&request, 0, sizeof(request));
+    request.op   = RPC_OP_STEPS;
+    request.data = cmd->arg.steps.step;
+    request.len  = cmd->arg.steps.count;
+
+    (void)ulTaskNotifyTake(pdTRUE, 0u);
+    if(!Rpc_Call(&request, &Control_StepsDone, NULL))
+    {
+        LOG_WRN("STEPS: the CM0+ did not take the call \r\n");
+        return;
+    }
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    LOG_INF("STEPS GATT Client: %d steps, status %d, %u ticks \r\n",
+            controlReply.arg[0], controlReply.status, controlReply.arg[2] - controlReply.arg[1]);
+}
+
+/*******************************************************************************
+* Function: Control_Execute
+* Input:    cmd - command taken from the queue
+* Return:   void
+* Description:
+*    Carries out one command
+*******************************************************************************/
+static void Control_Execute(const control_cmd_t *cmd)
+{
+    cy_stc_ble_gatt_value_t value;
+
+    switch(cmd->type)
+    {
+        case CONTROL_CMD_LED:
+            Cy_TCPWM_PWM_SetCompare0(PWM_DIM_HW, PWM_DIM_CNT_NUM, cmd->arg.value);
+            LOG_INF("GREEN GATT Client: %x \r\n", cmd->arg.value);
+            break;
+
+        case CONTROL_CMD_PA:
+            Regs_Write(REGS_PA, cmd->arg.value);
+            LOG_INF("PA GATT Client: %x \r\n", cmd->arg.value);
+            break;
+
+        case CONTROL_CMD_MUX:
+            Seq_Stop();
+            Regs_Write(REGS_MUX, cmd->arg.value);
+            LOG_INF("MUX GATT Client: %x \r\n", cmd->arg.value);
+            break;
+
+        case CONTROL_CMD_OSC:
+            Regs_Write(REGS_OSC, cmd->arg.value);
+            LOG_INF("OSC Client: %x \r\n", cmd->arg.value);
+            break;
+
+        case CONTROL_CMD_MISC:
+            Regs_Write(REGS_MISC, cmd->arg.value);
+            LOG_INF("MISC GATT Client: %x \r\n", cmd->arg.value);
+            break;
+
+        case CONTROL_CMD_CONFIG:
+            Seq_Stop();
+            Regs_WriteAll(cmd->arg.regs);
+            LOG_INF("CONFIG GATT Client: PA %x MUX %x OSC %x MISC %x \r\n",
+                    cmd->arg.regs[REGS_PA], cmd->arg.regs[REGS_MUX],
+                    cmd->arg.regs[REGS_OSC], cmd->arg.regs[REGS_MISC]);
+            break;
+
+        case CONTROL_CMD_SEQ:
+            value.val       = (uint8_t *)cmd->arg.seq.data;
+            value.len       = cmd->arg.seq.len;
+            value.actualLen = cmd->arg.seq.len;
+            (void)Seq_Write(&value, cmd->arg.seq.idle);
+            LOG_INF("SEQ GATT Client: %d bytes \r\n", cmd->arg.seq.len);
+            break;
+
+        case CONTROL_CMD_STEPS:
+            Control_Steps(cmd);
+            break;
+
+        default:
+            LOG_WRN("Control: unknown command %d \r\n", cmd->type);
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function: Control_Task
+* Input:    arg - unused
+* Return:   void
+* Description:
+*    Carries out commands in the order they were posted
+*******************************************************************************/
+static void Control_Task(void *arg)
+{
+    control_cmd_t cmd;
+
+    (void)arg;
+
+    for(;;)
+    {
+        if(xQueueReceive(controlQueue, &cmd, portMAX_DELAY) == pdTRUE)
+        {
+            Control_Execute(&cmd);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function: Control_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Creates the command queue and the control task. Call before the
+*    scheduler.
+*******************************************************************************/
+void Control_Init(void)
+{
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    controlQueue = xQueueCreateStatic(CONTROL_QUEUE_DEPTH, sizeof(control_cmd_t),
+                                      controlQueueStorage, &controlQueueBuffer);
+    controlTask = xTaskCreateStatic(Control_Task, "ctrlTask", CONTROL_TASK_STACK, NULL, CONTROL_TASK_PRIORITY,
+                                    controlTaskStack, &controlTaskTcb);
+#else
+    controlQueue = xQueueCreate(CONTROL_QUEUE_DEPTH, sizeof(control_cmd_t));
+    if((controlQueue == NULL) ||
+       (xTaskCreate(Control_Task, "ctrlTask", CONTROL_TASK_STACK, NULL, CONTROL_TASK_PRIORITY, &controlTask) != pdPASS))
+    {
+        LOG_ERR("Control task was not created\r\n");
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function: Control_Post
+* Input:    cmd - command to carry out
+* Return:   false if the queue was full and the command dropped
+* Description:
+*    Never blocks. The command is copied.
+*******************************************************************************/
+bool Control_Post(const control_cmd_t *cmd)
+{
+    if((controlQueue == NULL) || (xQueueSend(controlQueue, cmd, 0u) != pdTRUE))
+    {
+        controlRejected++;
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function: Control_PostValue
+* Input:    type  - LED, PA, MUX, OSC or MISC
+*           value - brightness or register code
+* Return:   false if the queue was full and the command dropped
+*******************************************************************************/
+bool Control_PostValue(control_cmd_type_t type, uint32_t value)
+{
+    control_cmd_t cmd;
+
+    cmd.type      = type;
+    cmd.arg.value = value;
+    return Control_Post(&cmd);
+}
+
+/*******************************************************************************
+* Function: Control_GetRejected
+* Input:    void
+* Return:   number of commands refused because the queue was full
+*******************************************************************************/
+uint32_t Control_GetRejected(void)
+{
+    return controlRejected;
+}
+
+/* [] END OF FILE */
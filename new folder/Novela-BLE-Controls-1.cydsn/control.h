@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: control.h
+*
+* Version: 1.20
+*
+* Description:
+*   Control task. The BLE event handler only decodes and validates writes
+*   and posts them here as typed commands; pins, PWM and the sequencer are
+*   driven by this task, in the order the writes arrived. Nothing this task
+*   does can delay Cy_BLE_ProcessEvents().
+*
+*   Timed register steps (STEPS) run on the CM0+ (rpc.h). For those the
+*   task stops the sequencer and blocks until the CM0+ replies, so the
+*   front end ports have a single owner at any time: the sequencer ISR
+*   and this task are the only writers on the CM4.
+*
+*   CONTROL_TASK_PRIORITY sets the split against the BLE task: below it
+*   (default) BLE events always go first; above it a command is carried out
+*   as soon as it is posted.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CONTROL_H
+
+    #define CONTROL_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "regs.h"
+    #include "rpc.h"
+    #include "seq.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define CONTROL_QUEUE_DEPTH         (16u)   /* commands                     */
+    #define CONTROL_TASK_STACK          (256u)  /* words                        */
+    #ifndef CONTROL_TASK_PRIORITY
+        #define CONTROL_TASK_PRIORITY   (1u)    /* BLE task is 2                */
+    #endif
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef enum
+    {
+        CONTROL_CMD_LED,        /* green LED brightness 0..100          */
+        CONTROL_CMD_PA,         /* one register code                    */
+        CONTROL_CMD_MUX,        /* stops a running sweep first          */
+        CONTROL_CMD_OSC,
+        CONTROL_CMD_MISC,
+        CONTROL_CMD_CONFIG,     /* all four registers, stops a sweep    */
+        CONTROL_CMD_SEQ,        /* SEQ write, already validated         */
+        CONTROL_CMD_STEPS       /* timed steps on the CM0+, stops a sweep */
+    } control_cmd_type_t;
+
+    typedef struct
+    {
+        control_cmd_type_t type;
+        union
+        {
+            uint32_t value;
+            uint32_t regs[REGS_COUNT];
+            struct
+            {
+                uint32_t idle;      /* MUX code when the sweep ends     */
+                uint16_t len;
+                uint8_t  data[SEQ_HEADER_SIZE + SEQ_MAX_CHANNELS];
+            } seq;
+            struct
+            {
+                uint32_t   count;
+                rpc_step_t step[RPC_MAX_STEPS];
+            } steps;
+        } arg;
+    } control_cmd_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void Control_Init(void);
+    bool Control_Post(const control_cmd_t *cmd);
+    bool Control_PostValue(control_cmd_type_t type, uint32_t value);
+    uint32_t Control_GetRejected(void);
+
+#endif
+
+/* [] END OF FILE */
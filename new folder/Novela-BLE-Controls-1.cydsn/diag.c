@@ -0,0 +1,243 @@
+/*******************************************************************************
+* File Name: diag.c
+*
+* Version: 1.20
+*
+* Description:
+*   CM4 run time statistics, see diag.h.
+*   Diag_InitTimer() and Diag_GetTime() are the FreeRTOS run time counter
+*   hooks (FreeRTOSConfig.h); Diag_Process() runs in the BLE task, the
+*   only task that touches the GATT database.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#define LOG_MODULE DIAG
+
+#include "diag.h"
+#include "lat.h"
+#include "log.h"
+#include "task.h"
+#include <string.h>
+
+/*********************************************************************
+* Counter configuration                                              *
+**********************************************************************/
+static const cy_stc_tcpwm_counter_config_t diagCounterConfig =
+{
+    .period             = 0xFFFFFFFFUL,     /* free running */
+    .clockPrescaler     = CY_TCPWM_COUNTER_PRESCALER_DIVBY_1,
+    .runMode            = CY_TCPWM_COUNTER_CONTINUOUS,
+    .countDirection     = CY_TCPWM_COUNTER_COUNT_UP,
+    .compareOrCapture   = CY_TCPWM_COUNTER_MODE_COMPARE,
+    .compare0           = 0UL,
+    .compare1           = 0UL,
+    .enableCompareSwap  = false,
+    .interruptSources   = CY_TCPWM_INT_NONE,
+    .captureInputMode   = CY_TCPWM_INPUT_RISINGEDGE,
+    .captureInput       = CY_TCPWM_INPUT_0,
+    .reloadInputMode    = CY_TCPWM_INPUT_RISINGEDGE,
+    .reloadInput        = CY_TCPWM_INPUT_0,
+    .startInputMode     = CY_TCPWM_INPUT_RISINGEDGE,
+    .startInput         = CY_TCPWM_INPUT_0,
+    .stopInputMode      = CY_TCPWM_INPUT_RISINGEDGE,
+    .stopInput          = CY_TCPWM_INPUT_0,
+    .countInputMode     = CY_TCPWM_INPUT_LEVEL,
+    .countInput         = CY_TCPWM_INPUT_1,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   BLE task only                                                    *
+**********************************************************************/
+typedef struct
+{
+    UBaseType_t number;
+    uint32_t    runTime;
+} diag_prev_t;
+
+static TaskStatus_t diagTasks[DIAG_MAX_TASKS];
+static diag_prev_t  diagPrev[DIAG_MAX_TASKS];
+static uint32_t     diagPrevTotal = 0u;
+static TickType_t   diagLast = 0u;
+static uint8_t      diagValue[DIAG_VALUE_SIZE];
+
+/*******************************************************************************
+* Function: Diag_Put16
+* Input:    p     - where to store
+*           value - low 16 bits are stored, little endian
+* Return:   void
+*******************************************************************************/
+static void Diag_Put16(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8u);
+}
+
+/*******************************************************************************
+* Function: Diag_Put32
+* Input:    p     - where to store
+*           value - stored little endian
+* Return:   void
+*******************************************************************************/
+static void Diag_Put32(uint8_t *p, uint32_t value)
+{
+    Diag_Put16(&p[0], value);
+    Diag_Put16(&p[2], value >> 16u);
+}
+
+/*******************************************************************************
+* Function: Diag_Delta
+* Input:    number  - task number
+*           runTime - run time counter of the task now
+*           prev    - counters at the end of the last window
+*           count   - entries in prev
+* Return:   run time of the task since the last window
+* Description:
+*    A task that was not there in the last window counts from its start
+*******************************************************************************/
+static uint32_t Diag_Delta(UBaseType_t number, uint32_t runTime, diag_prev_t *prev, uint32_t count)
+{
+    uint32_t i;
+
+    for(i = 0u; i < count; i++)
+    {
+        if(prev[i].number == number)
+        {
+            return runTime - prev[i].runTime;
+        }
+    }
+    return runTime;
+}
+
+/*******************************************************************************
+* Function: Diag_Sample
+* Input:    void
+* Return:   void
+* Description:
+*    Takes one window of statistics, logs it and updates the DIAG value
+*******************************************************************************/
+static void Diag_Sample(void)
+{
+    diag_prev_t prev[DIAG_MAX_TASKS];
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    uint32_t total;
+    uint32_t window;
+    uint32_t delta;
+    uint32_t share;
+    uint32_t count;
+    uint32_t i;
+    uint8_t *p;
+    const char *name;
+
+    count  = uxTaskGetSystemState(diagTasks, DIAG_MAX_TASKS, &total);
+    window = total - diagPrevTotal;
+    diagPrevTotal = total;
+
+    /* Last window's counts, by task number; the table is rebuilt below */
+    memcpy(prev, diagPrev, sizeof(prev));
+
+    memset(diagValue, 0, sizeof(diagValue));
+    diagValue[0] = (uint8_t)count;
+    Diag_Put32(&diagValue[1], (uint32_t)xPortGetFreeHeapSize());
+    Diag_Put32(&diagValue[5], window);
+
+    LOG_INF("diag: %lu tasks, window %lu us, heap free %lu\r\n",
+            (unsigned long)count, (unsigned long)window, (unsigned long)xPortGetFreeHeapSize());
+
+    for(i = 0u; i < count; i++)
+    {
+        delta = Diag_Delta(diagTasks[i].xTaskNumber, diagTasks[i].ulRunTimeCounter, prev, DIAG_MAX_TASKS);
+        diagPrev[i].number  = diagTasks[i].xTaskNumber;
+        diagPrev[i].runTime = diagTasks[i].ulRunTimeCounter;
+
+        share = (window != 0u) ? (uint32_t)(((uint64_t)delta * 1000u) / window) : 0u;
+        name  = diagTasks[i].pcTaskName;
+
+        p = &diagValue[DIAG_HEADER_SIZE + (i * DIAG_TASK_SIZE)];
+        strncpy((char *)p, name, DIAG_NAME_SIZE);
+        Diag_Put16(&p[DIAG_NAME_SIZE], share);
+        Diag_Put16(&p[DIAG_NAME_SIZE + 2u], diagTasks[i].usStackHighWaterMark);
+        p[DIAG_NAME_SIZE + 4u] = (uint8_t)diagTasks[i].uxCurrentPriority;
+        p[DIAG_NAME_SIZE + 5u] = (uint8_t)diagTasks[i].xTaskNumber;
+
+        /* Log arguments are numbers only: the first characters of the name */
+        LOG_INF("  %c%c%c%c%c cpu %lu.%lu%% stack free %lu\r\n",
+                (p[0] != 0u) ? p[0] : ' ', (p[1] != 0u) ? p[1] : ' ', (p[2] != 0u) ? p[2] : ' ',
+                (p[3] != 0u) ? p[3] : ' ', (p[4] != 0u) ? p[4] : ' ',
+                (unsigned long)(share / 10u), (unsigned long)(share % 10u),
+                (unsigned long)diagTasks[i].usStackHighWaterMark);
+    }
+    for(; i < DIAG_MAX_TASKS; i++)
+    {
+        diagPrev[i].number  = 0u;
+        diagPrev[i].runTime = 0u;
+    }
+
+    handleValuePair.attrHandle = CY_BLE_LED_DIAG_CHAR_HANDLE;
+    handleValuePair.value.val  = diagValue;
+    handleValuePair.value.len  = (uint16_t)(DIAG_HEADER_SIZE + (count * DIAG_TASK_SIZE));
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+}
+
+/*******************************************************************************
+* Function: Diag_InitTimer
+* Input:    void
+* Return:   void
+* Description:
+*    portCONFIGURE_TIMER_FOR_RUN_TIME_STATS(), called by
+*    vTaskStartScheduler(). Starts the free running 1 MHz counter.
+*******************************************************************************/
+void Diag_InitTimer(void)
+{
+    (void)Cy_SysClk_PeriphAssignDivider(DIAG_TCPWM_PCLK, CY_SYSCLK_DIV_16_BIT, DIAG_CLOCK_DIV_NUM);
+    (void)Cy_SysClk_PeriphSetDivider(CY_SYSCLK_DIV_16_BIT, DIAG_CLOCK_DIV_NUM, DIAG_CLOCK_DIVIDER);
+    (void)Cy_SysClk_PeriphEnableDivider(CY_SYSCLK_DIV_16_BIT, DIAG_CLOCK_DIV_NUM);
+
+    (void)Cy_TCPWM_Counter_Init(DIAG_TCPWM_HW, DIAG_TCPWM_CNT_NUM, &diagCounterConfig);
+    Cy_TCPWM_Enable_Multiple(DIAG_TCPWM_HW, DIAG_TCPWM_CNT_MASK);
+    Cy_TCPWM_TriggerStart(DIAG_TCPWM_HW, DIAG_TCPWM_CNT_MASK);
+}
+
+/*******************************************************************************
+* Function: Diag_GetTime
+* Input:    void
+* Return:   run time counter, us
+* Description:
+*    portGET_RUN_TIME_COUNTER_VALUE(), called on every context switch
+*******************************************************************************/
+uint32_t Diag_GetTime(void)
+{
+    return Cy_TCPWM_Counter_GetCounter(DIAG_TCPWM_HW, DIAG_TCPWM_CNT_NUM);
+}
+
+/*******************************************************************************
+* Function: Diag_Process
+* Input:    void
+* Return:   ticks until the next window is due
+* Description:
+*    Called from the BLE task loop once the stack is on. The latency
+*    histograms are published with the same window.
+*******************************************************************************/
+TickType_t Diag_Process(void)
+{
+    TickType_t elapsed = xTaskGetTickCount() - diagLast;
+
+    if(elapsed < pdMS_TO_TICKS(DIAG_WINDOW_MS))
+    {
+        return pdMS_TO_TICKS(DIAG_WINDOW_MS) - elapsed;
+    }
+
+    diagLast += elapsed;
+    Diag_Sample();
+    Lat_Publish();
+    return pdMS_TO_TICKS(DIAG_WINDOW_MS);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* File Name: diag.h
+*
+* Version: 1.20
+*
+* Description:
+*   CM4 run time statistics. FreeRTOS counts the time of each task on
+*   TCPWM0 counter 3 (1 MHz, 32 bit); once per DIAG_WINDOW_MS the BLE task
+*   turns the counts of the last window into a CPU share per task, adds the
+*   stack high water marks and the free heap, logs them on UART_1 and puts
+*   them in the readable DIAG characteristic.
+*
+*   The counter stops in Deep Sleep, so shares are of the time the CM4 was
+*   awake. The idle task's share is the headroom left.
+*
+*   DIAG value, little endian:
+*       [0]     number of tasks that follow
+*       [1..4]  free heap, bytes
+*       [5..8]  window length, counter ticks (us)
+*       then per task DIAG_TASK_SIZE bytes:
+*       [0..7]  task name, zero padded
+*       [8..9]  CPU share over the window, 1/1000
+*       [10..11] stack never used so far, words
+*       [12]    priority
+*       [13]    task number
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef DIAG_H
+
+    #define DIAG_H
+
+    #include <project.h>
+    #include "FreeRTOS.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define DIAG_WINDOW_MS              (5000u)
+    #define DIAG_MAX_TASKS              (8u)
+    #define DIAG_NAME_SIZE              (8u)
+    #define DIAG_HEADER_SIZE            (9u)
+    #define DIAG_TASK_SIZE              (DIAG_NAME_SIZE + 6u)
+    #define DIAG_VALUE_SIZE             (DIAG_HEADER_SIZE + (DIAG_MAX_TASKS * DIAG_TASK_SIZE))
+
+    /* The Timer component in TopDesign is not placed, so the run time
+       counter is TCPWM0 counter 3, driven directly like the sequencer */
+    #define DIAG_TCPWM_HW               TCPWM0
+    #define DIAG_TCPWM_CNT_NUM          (3u)
+    #define DIAG_TCPWM_CNT_MASK         (1UL << DIAG_TCPWM_CNT_NUM)
+    #define DIAG_TCPWM_PCLK             PCLK_TCPWM0_CLOCKS3
+    #define DIAG_CLOCK_DIV_NUM          (2u)    /* 16 bit divider, #1 is SEQ       */
+    #define DIAG_CLOCK_DIVIDER          (49u)   /* clk_peri 50 MHz / 50 = 1 MHz    */
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void       Diag_InitTimer(void);
+    uint32_t   Diag_GetTime(void);
+    TickType_t Diag_Process(void);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,436 @@
+/*******************************************************************************
+* File Name: dsp.c
+*
+* Version: 1.20
+*
+* Description:
+*   Filter and decimation stage, see dsp.h.
+*   Everything here runs in the BLE task: Dsp_Filter() from Stream_Process()
+*   and Dsp_Write() from the GATT write event, so the configuration and the
+*   channel state need no locking.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "dsp.h"
+#include <string.h>
+
+#define DSP_PI                  (3.14159265f)
+#define DSP_COEF_SHIFT          (30u)   /* biquad coefficients are q30, up to 2 */
+#define DSP_FIR_SHIFT           (15u)
+#define DSP_CODE_MAX            (0x0FFF)
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+typedef struct
+{
+    dsp_biquad_t notch;
+    int16_t      hist[2u * DSP_FIR_TAPS];   /* each input twice, see Dsp_Lowpass */
+    uint8_t      pos;
+    uint8_t      phase;                     /* inputs since the last output     */
+} dsp_channel_t;
+
+static dsp_channel_t dspChannel[STREAM_CHANNELS];
+
+/* Configuration, as read back */
+static uint8_t  dspFlags = 0u;
+static uint8_t  dspMains = 50u;
+static uint16_t dspRate = 0u;
+static uint16_t dspCutoff = 0u;
+static uint8_t  dspDecimate = 1u;
+
+/* Coefficients */
+static int32_t  dspNotch[DSP_BIQUAD_COEFS];
+static int16_t  dspFir[DSP_FIR_TAPS];   /* symmetric, q15                   */
+
+/*******************************************************************************
+* Function: Dsp_Cos
+* Input:    x - angle, radians
+* Return:   cos(x), to float precision
+* Description:
+*    Series on 0 .. pi/2, so the stage needs nothing from libm
+*******************************************************************************/
+static float Dsp_Cos(float x)
+{
+    float sign = 1.0f;
+    float x2;
+    float term = 1.0f;
+    float sum = 1.0f;
+    uint32_t i;
+
+    while(x > DSP_PI)
+    {
+        x -= 2.0f * DSP_PI;
+    }
+    while(x < -DSP_PI)
+    {
+        x += 2.0f * DSP_PI;
+    }
+    if(x < 0.0f)
+    {
+        x = -x;
+    }
+    if(x > (0.5f * DSP_PI))
+    {
+        x    = DSP_PI - x;
+        sign = -1.0f;
+    }
+
+    x2 = x * x;
+    for(i = 1u; i < 8u; i++)
+    {
+        term *= -x2 / (float)((2u * i - 1u) * (2u * i));
+        sum  += term;
+    }
+    return sign * sum;
+}
+
+/*******************************************************************************
+* Function: Dsp_Fixed
+* Input:    v     - coefficient
+*           shift - fraction bits
+* Return:   v rounded to 32 bits, saturated
+*******************************************************************************/
+static int32_t Dsp_Fixed(float v, uint32_t shift)
+{
+    float scaled = v * (float)(1uLL << shift);
+
+    if(scaled >= 2147483647.0f)
+    {
+        return INT32_MAX;
+    }
+    if(scaled <= -2147483648.0f)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)((scaled < 0.0f) ? (scaled - 0.5f) : (scaled + 0.5f));
+}
+
+/*******************************************************************************
+* Function: Dsp_Read2
+* Input:    p - two q15 values, any alignment
+* Return:   them as one word; the CM4 loads unaligned words
+*******************************************************************************/
+static uint32_t Dsp_Read2(const int16_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*******************************************************************************
+* Function: Dsp_Design
+* Input:    void
+* Return:   void
+* Description:
+*    Works out the coefficients for the configuration in force. The notch
+*    has its zeros on the unit circle at the mains frequency and its poles
+*    just inside, DSP_NOTCH_WIDTH_HZ apart, scaled for unity gain away from
+*    the notch. The low-pass is a Hamming windowed sinc with unity DC gain.
+*******************************************************************************/
+static void Dsp_Design(void)
+{
+    float w;
+    float c;
+    float r;
+    float g;
+    float fc;
+    float t;
+    float h[DSP_FIR_TAPS];
+    float sum = 0.0f;
+    uint32_t i;
+
+    if((dspFlags & DSP_FLAG_NOTCH) != 0u)
+    {
+        w = 2.0f * DSP_PI * (float)dspMains / (float)dspRate;
+        c = Dsp_Cos(w);
+        r = 1.0f - (DSP_PI * DSP_NOTCH_WIDTH_HZ / (float)dspRate);
+        g = (1.0f - 2.0f * r * c + r * r) / (2.0f - 2.0f * c);
+
+        dspNotch[0] = Dsp_Fixed(g, DSP_COEF_SHIFT);
+        dspNotch[1] = Dsp_Fixed(-2.0f * c * g, DSP_COEF_SHIFT);
+        dspNotch[2] = dspNotch[0];
+        dspNotch[3] = Dsp_Fixed(2.0f * r * c, DSP_COEF_SHIFT);
+        dspNotch[4] = Dsp_Fixed(-r * r, DSP_COEF_SHIFT);
+    }
+
+    if((dspFlags & DSP_FLAG_LOWPASS) != 0u)
+    {
+        fc = (float)dspCutoff / (float)dspRate;
+        for(i = 0u; i < DSP_FIR_TAPS; i++)
+        {
+            /* Half way between taps, never 0 with an even count */
+            t    = DSP_PI * ((float)i - (0.5f * (float)(DSP_FIR_TAPS - 1u)));
+            h[i] = (Dsp_Cos((2.0f * fc * t) - (0.5f * DSP_PI)) / t)
+                 * (0.54f - 0.46f * Dsp_Cos(2.0f * DSP_PI * (float)i / (float)(DSP_FIR_TAPS - 1u)));
+            sum += h[i];
+        }
+        for(i = 0u; i < DSP_FIR_TAPS; i++)
+        {
+            dspFir[i] = (int16_t)__SSAT(Dsp_Fixed(h[i] / sum, DSP_FIR_SHIFT), 16);
+        }
+    }
+
+    memset(dspChannel, 0, sizeof(dspChannel));
+}
+
+/*******************************************************************************
+* Function: Dsp_Biquad
+* Input:    coef  - b0, b1, b2, -a1, -a2, q30
+*           state - filter history
+*           x     - input, q15
+* Return:   output, q15
+* Description:
+*    Direct form I biquad, q31 state and 64 bit accumulation (SMLAL), as
+*    arm_biquad_cas_df1_32x64_q31(). A mains notch at a few kHz channel
+*    rate has its poles too close to 1 for q15 coefficients.
+*******************************************************************************/
+int16_t Dsp_Biquad(const int32_t coef[DSP_BIQUAD_COEFS], dsp_biquad_t *state, int16_t x)
+{
+    int32_t in = (int32_t)x * 65536;
+    int64_t acc;
+    int32_t y;
+
+    acc = ((int64_t)coef[0] * in)
+        + ((int64_t)coef[1] * state->x[0])
+        + ((int64_t)coef[2] * state->x[1])
+        + ((int64_t)coef[3] * state->y[0])
+        + ((int64_t)coef[4] * state->y[1]);
+    acc >>= DSP_COEF_SHIFT;
+    y = (acc > INT32_MAX) ? INT32_MAX : ((acc < INT32_MIN) ? INT32_MIN : (int32_t)acc);
+
+    state->x[1] = state->x[0];
+    state->x[0] = in;
+    state->y[1] = state->y[0];
+    state->y[0] = y;
+    return (int16_t)__SSAT((int32_t)(((int64_t)y + 32768) >> 16), 16);
+}
+
+/*******************************************************************************
+* Function: Dsp_Bandpass
+* Input:    coef   - biquad coefficients to fill
+*           lowHz  - lower -3 dB edge
+*           highHz - upper -3 dB edge, above lowHz and below rateHz / 2
+*           rateHz - sample rate
+* Return:   void
+* Description:
+*    Second order band-pass with unity gain at the centre, for Dsp_Biquad().
+*    Float, so for a configuration write and not per sample.
+*******************************************************************************/
+void Dsp_Bandpass(int32_t coef[DSP_BIQUAD_COEFS], uint32_t lowHz, uint32_t highHz, uint32_t rateHz)
+{
+    float w = DSP_PI * (float)(lowHz + highHz) / (float)rateHz;
+    float q = 0.5f * (float)(lowHz + highHz) / (float)(highHz - lowHz);
+    float alpha = Dsp_Cos(w - (0.5f * DSP_PI)) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    coef[0] = Dsp_Fixed(alpha / a0, DSP_COEF_SHIFT);
+    coef[1] = 0;
+    coef[2] = -coef[0];
+    coef[3] = Dsp_Fixed(2.0f * Dsp_Cos(w) / a0, DSP_COEF_SHIFT);
+    coef[4] = Dsp_Fixed(-(1.0f - alpha) / a0, DSP_COEF_SHIFT);
+}
+
+/*******************************************************************************
+* Function: Dsp_ToQ15
+* Input:    code - ADC code
+* Return:   the code centred and scaled as the filters take it
+*******************************************************************************/
+int16_t Dsp_ToQ15(uint16_t code)
+{
+    return (int16_t)__SSAT(((int32_t)code - DSP_MIDSCALE) * (1 << DSP_INPUT_SHIFT), 16);
+}
+
+/*******************************************************************************
+* Function: Dsp_Lowpass
+* Input:    c - channel state
+*           x - input, q15
+*           y - output, q15, when there is one
+* Return:   true when this input completes an output
+* Description:
+*    Decimating FIR. Every input goes into the history at pos and
+*    pos + DSP_FIR_TAPS, so the last DSP_FIR_TAPS inputs are always in one
+*    run and the MAC loop needs no wrap. Only the kept outputs are computed.
+*******************************************************************************/
+static bool Dsp_Lowpass(dsp_channel_t *c, int16_t x, int16_t *y)
+{
+    const int16_t *window;
+    uint64_t acc = 0u;
+    uint32_t i;
+
+    c->hist[c->pos]                = x;
+    c->hist[c->pos + DSP_FIR_TAPS] = x;
+    c->pos = (uint8_t)((c->pos + 1u) % DSP_FIR_TAPS);
+
+    if(++c->phase < dspDecimate)
+    {
+        return false;
+    }
+    c->phase = 0u;
+
+    /* Oldest first; the taps are symmetric, so no reversal */
+    window = &c->hist[c->pos];
+    for(i = 0u; i < DSP_FIR_TAPS; i += 2u)
+    {
+        acc = __SMLALD(Dsp_Read2(&window[i]), Dsp_Read2(&dspFir[i]), acc);
+    }
+
+    *y = (int16_t)__SSAT((int32_t)(((int64_t)acc + (1 << (DSP_FIR_SHIFT - 1u))) >> DSP_FIR_SHIFT), 16);
+    return true;
+}
+
+/*******************************************************************************
+* Function: Dsp_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Starts with the stage off. Call before the scheduler.
+*******************************************************************************/
+void Dsp_Init(void)
+{
+    memset(dspChannel, 0, sizeof(dspChannel));
+}
+
+/*******************************************************************************
+* Function: Dsp_Filter
+* Input:    sample - sample on its way into the STREAM ring, filtered in place
+* Return:   true if the sample is to be kept, false if decimation drops it
+*******************************************************************************/
+bool Dsp_Filter(stream_sample_t *sample)
+{
+    dsp_channel_t *c;
+    int32_t v;
+    int16_t x;
+
+    if((dspFlags == 0u) && (dspDecimate <= 1u))
+    {
+        return true;
+    }
+    c = &dspChannel[sample->channel & (STREAM_CHANNELS - 1u)];
+
+    x = Dsp_ToQ15(sample->value);
+
+    if((dspFlags & DSP_FLAG_NOTCH) != 0u)
+    {
+        x = Dsp_Biquad(dspNotch, &c->notch, x);
+    }
+
+    if((dspFlags & DSP_FLAG_LOWPASS) != 0u)
+    {
+        if(!Dsp_Lowpass(c, x, &x))
+        {
+            return false;
+        }
+    }
+    else if(++c->phase < dspDecimate)
+    {
+        return false;
+    }
+    else
+    {
+        c->phase = 0u;
+    }
+
+    v = ((int32_t)x / (1 << DSP_INPUT_SHIFT)) + DSP_MIDSCALE;
+    sample->value = (uint16_t)((v < 0) ? 0 : ((v > DSP_CODE_MAX) ? DSP_CODE_MAX : v));
+    return true;
+}
+
+/*******************************************************************************
+* Function: Dsp_UpdateValue
+* Input:    void
+* Return:   void
+* Description:
+*    Keeps the readable DSP value in line with the configuration. Call once
+*    the BLE stack is on.
+*******************************************************************************/
+void Dsp_UpdateValue(void)
+{
+    uint8_t value[DSP_VALUE_SIZE];
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+
+    value[0] = dspFlags;
+    value[1] = dspMains;
+    value[2] = (uint8_t)dspRate;
+    value[3] = (uint8_t)(dspRate >> 8u);
+    value[4] = (uint8_t)dspCutoff;
+    value[5] = (uint8_t)(dspCutoff >> 8u);
+    value[6] = dspDecimate;
+    value[7] = 0u;
+
+    handleValuePair.attrHandle = CY_BLE_LED_DSP_CHAR_HANDLE;
+    handleValuePair.value.val  = value;
+    handleValuePair.value.len  = DSP_VALUE_SIZE;
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+}
+
+/*******************************************************************************
+* Function: Dsp_Write
+* Input:    value - the value written to the DSP characteristic
+* Return:   GATT error to report back to the client
+* Description:
+*    Checks and applies a configuration, layout in dsp.h. A refused write
+*    leaves the stage as it was.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Dsp_Write(const cy_stc_ble_gatt_value_t *value)
+{
+    uint32_t flags;
+    uint32_t mains;
+    uint32_t rate;
+    uint32_t cutoff;
+    uint32_t decimate;
+
+    if(value->len != DSP_VALUE_SIZE)
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+    flags    = value->val[0];
+    mains    = value->val[1];
+    rate     = value->val[2] | ((uint32_t)value->val[3] << 8u);
+    cutoff   = value->val[4] | ((uint32_t)value->val[5] << 8u);
+    decimate = (value->val[6] == 0u) ? 1u : value->val[6];
+
+    if(((flags & ~(DSP_FLAG_NOTCH | DSP_FLAG_LOWPASS)) != 0u) || (decimate > DSP_MAX_DECIMATE))
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+    if((flags != 0u) && (rate == 0u))
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+    if(((flags & DSP_FLAG_NOTCH) != 0u) && ((mains == 0u) || ((2u * mains) >= rate)))
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+    if((flags & DSP_FLAG_LOWPASS) != 0u)
+    {
+        if(cutoff == 0u)
+        {
+            cutoff = (rate * DSP_CUTOFF_PERCENT) / (200u * decimate);
+        }
+        if((cutoff == 0u) || ((2u * cutoff) >= rate))
+        {
+            return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+        }
+    }
+
+    dspFlags    = (uint8_t)flags;
+    dspMains    = (uint8_t)mains;
+    dspRate     = (uint16_t)rate;
+    dspCutoff   = (uint16_t)cutoff;
+    dspDecimate = (uint8_t)decimate;
+    Dsp_Design();
+
+    Dsp_UpdateValue();
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: dsp.h
+*
+* Version: 1.20
+*
+* Description:
+*   Filter and decimation stage for the sample stream, on the CM4. Each MUX
+*   channel has its own state: a mains notch (biquad) then a low-pass FIR
+*   that keeps one output in DSP decimation. Stream_Process() runs every
+*   sample through Dsp_Filter() on its way into the STREAM ring, so with
+*   decimation N only every Nth sample is coded and sent.
+*
+*   Samples are 12 bit ADC codes (acq.h). They are centred and scaled to
+*   q15 with DSP_INPUT_SHIFT bits of headroom for the filter overshoot, and
+*   scaled back to codes on the way out, so the host reads the same units
+*   with or without the stage. The notch keeps q31 state with q30
+*   coefficients, as CMSIS-DSP arm_biquad_cas_df1_32x64_q31(); the FIR
+*   is q15 on the dual 16 bit MAC (SMLALD), as arm_fir_decimate_q15().
+*
+*   The coefficients are worked out in float on a write, never per sample.
+*   The FIR is linear phase: outputs lag by (DSP_FIR_TAPS - 1) / 2 input
+*   samples of their channel, and keep the time of the newest input.
+*
+*   DSP characteristic, read and write, little endian:
+*       [0]     DSP_FLAG_ bits
+*       [1]     mains frequency, Hz, below half the channel rate
+*       [2..3]  sample rate of one MUX channel, Hz
+*       [4..5]  low-pass cutoff, Hz, below half the channel rate;
+*               0 picks DSP_CUTOFF_PERCENT of the output Nyquist rate
+*       [6]     decimation 1 .. DSP_MAX_DECIMATE, 0 is taken as 1;
+*               without DSP_FLAG_LOWPASS every Nth sample is kept as is
+*       [7]     reserved, 0
+*   No flags and decimation 1 turn the stage off. The value reads back as
+*   applied, with the cutoff picked. A write clears the filter state of
+*   every channel.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef DSP_H
+
+    #define DSP_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "stream.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define DSP_VALUE_SIZE              (8u)
+    #define DSP_FLAG_NOTCH              (0x01u)
+    #define DSP_FLAG_LOWPASS            (0x02u)
+
+    #define DSP_FIR_TAPS                (32u)   /* even, for the pair MAC       */
+    #define DSP_MAX_DECIMATE            (16u)
+    #define DSP_CUTOFF_PERCENT          (80u)
+    #define DSP_NOTCH_WIDTH_HZ          (2.0f)  /* -3 dB width of the notch     */
+
+    #define DSP_MIDSCALE                (2048)  /* ADC code of 0 V input        */
+    #define DSP_INPUT_SHIFT             (3u)    /* 12 bit code to q15, 2x headroom */
+
+    #define DSP_BIQUAD_COEFS            (5u)    /* b0, b1, b2, -a1, -a2, q30    */
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef struct
+    {
+        int32_t x[2];                   /* x[n-1], x[n-2], q31              */
+        int32_t y[2];                   /* y[n-1], y[n-2], q31              */
+    } dsp_biquad_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void                      Dsp_Init(void);
+    bool                      Dsp_Filter(stream_sample_t *sample);
+    int16_t                   Dsp_ToQ15(uint16_t code);
+    void                      Dsp_Bandpass(int32_t coef[DSP_BIQUAD_COEFS], uint32_t lowHz,
+                                           uint32_t highHz, uint32_t rateHz);
+    int16_t                   Dsp_Biquad(const int32_t coef[DSP_BIQUAD_COEFS], dsp_biquad_t *state,
+                                         int16_t x);
+    void                      Dsp_UpdateValue(void);
+    cy_en_ble_gatt_err_code_t Dsp_Write(const cy_stc_ble_gatt_value_t *value);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,395 @@
+/*******************************************************************************
+* File Name: feat.c
+*
+* Version: 1.20
+*
+* Description:
+*   Feature mode, see feat.h.
+*   Everything here runs in the BLE task: Feat_Put() from Stream_Process(),
+*   Feat_Process() from the task loop and the writes from the GATT events.
+*   Per sample it is a few adds and one biquad; the divisions and square
+*   roots are left to the end of the window.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "feat.h"
+#include "dsp.h"
+#include "ts.h"
+#include "conn.h"
+#include "task.h"
+#include <string.h>
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+typedef struct
+{
+    uint32_t     count;
+    int64_t      sum;           /* codes about DSP_MIDSCALE             */
+    uint64_t     sumSq;
+    uint64_t     bandSq;        /* band-pass output, q15 squared        */
+    uint32_t     crossings;
+    int32_t      base;          /* mean of the previous window          */
+    bool         hasBase;
+    bool         above;         /* last sample past the threshold       */
+    dsp_biquad_t band;
+} feat_channel_t;
+
+static feat_channel_t           featChannel[STREAM_CHANNELS];
+
+/* Configuration */
+static bool                     featOn = false;
+static uint16_t                 featWindowMs = 1000u;
+static uint16_t                 featThreshold = 0u;
+static int32_t                  featBand[DSP_BIQUAD_COEFS];
+
+/* Window */
+static cy_stc_ble_conn_handle_t featConn;
+static bool                     featStarted = false;
+static uint32_t                 featStart;
+static uint16_t                 featSeq = 0u;
+static bool                     featPending = false;
+static uint16_t                 featLen = 0u;
+static uint8_t                  featValue[FEAT_VALUE_SIZE];
+
+/*******************************************************************************
+* Function: Feat_Put16 / Feat_Put32
+* Description:
+*    Little endian field writers for the FEATURES value
+*******************************************************************************/
+static void Feat_Put16(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8u);
+}
+
+static void Feat_Put32(uint8_t *p, uint32_t v)
+{
+    Feat_Put16(&p[0], v);
+    Feat_Put16(&p[2], v >> 16u);
+}
+
+/*******************************************************************************
+* Function: Feat_Sqrt
+* Input:    v - value
+* Return:   floor(sqrt(v))
+*******************************************************************************/
+static uint32_t Feat_Sqrt(uint64_t v)
+{
+    uint64_t root = 0u;
+    uint64_t bit = 1uLL << 62u;
+
+    while(bit > v)
+    {
+        bit >>= 2u;
+    }
+    while(bit != 0u)
+    {
+        if(v >= (root + bit))
+        {
+            v   -= root + bit;
+            root = (root >> 1u) + bit;
+        }
+        else
+        {
+            root >>= 1u;
+        }
+        bit >>= 2u;
+    }
+    return (uint32_t)root;
+}
+
+/*******************************************************************************
+* Function: Feat_Sat16
+* Input:    v - value
+* Return:   v, at most 0xFFFF
+*******************************************************************************/
+static uint32_t Feat_Sat16(uint64_t v)
+{
+    return (v > 0xFFFFu) ? 0xFFFFu : (uint32_t)v;
+}
+
+/*******************************************************************************
+* Function: Feat_Reset
+* Input:    void
+* Return:   void
+* Description:
+*    Drops the window in progress and the channel history
+*******************************************************************************/
+static void Feat_Reset(void)
+{
+    memset(featChannel, 0, sizeof(featChannel));
+    featStarted = false;
+    featPending = false;
+}
+
+/*******************************************************************************
+* Function: Feat_Close
+* Input:    void
+* Return:   void
+* Description:
+*    Turns the window into the FEATURES value, layout in feat.h, and starts
+*    the next one. The variance is sumSq - sum^2 / count, with sum split as
+*    mean * count + rest so nothing overflows.
+*******************************************************************************/
+static void Feat_Close(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    feat_channel_t *c;
+    uint8_t *p = &featValue[FEAT_HEADER_SIZE];
+    int64_t mean;
+    int64_t rest;
+    int64_t spread;
+    uint32_t n = 0u;
+    uint32_t ch;
+
+    for(ch = 0u; ch < STREAM_CHANNELS; ch++)
+    {
+        c = &featChannel[ch];
+        if(c->count == 0u)
+        {
+            continue;
+        }
+
+        mean   = c->sum / (int64_t)c->count;
+        rest   = c->sum - (mean * (int64_t)c->count);
+        spread = (int64_t)c->sumSq - ((mean * mean * (int64_t)c->count) + (2 * mean * rest)
+                                      + ((rest * rest) / (int64_t)c->count));
+        if(spread < 0)
+        {
+            spread = 0;
+        }
+
+        p[0] = (uint8_t)ch;
+        Feat_Put16(&p[1], Feat_Sat16(c->count));
+        Feat_Put16(&p[3], (uint32_t)(mean + DSP_MIDSCALE));
+        Feat_Put16(&p[5], Feat_Sat16(Feat_Sqrt(((uint64_t)spread * 256u) / c->count)));
+        Feat_Put32(&p[7], (uint32_t)((c->bandSq * 4u) / c->count));    /* (q15 / 8)^2 * 256 */
+        Feat_Put16(&p[11], Feat_Sat16(c->crossings));
+        p += FEAT_CHANNEL_SIZE;
+        n++;
+
+        c->base      = (int32_t)mean;
+        c->hasBase   = true;
+        c->above     = false;   /* judged against the old base */
+        c->count     = 0u;
+        c->sum       = 0;
+        c->sumSq     = 0u;
+        c->bandSq    = 0u;
+        c->crossings = 0u;
+    }
+
+    Feat_Put32(&featValue[0], featStart);
+    Feat_Put16(&featValue[4], featWindowMs);
+    Feat_Put16(&featValue[6], featSeq);
+    featValue[8] = (uint8_t)n;
+    featSeq++;
+
+    featLen     = (uint16_t)(FEAT_HEADER_SIZE + (n * FEAT_CHANNEL_SIZE));
+    featPending = true;
+
+    handleValuePair.attrHandle = CY_BLE_LED_FEATURES_CHAR_HANDLE;
+    handleValuePair.value.val  = featValue;
+    handleValuePair.value.len  = featLen;
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+}
+
+/*******************************************************************************
+* Function: Feat_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Starts with the mode off. Call before the scheduler.
+*******************************************************************************/
+void Feat_Init(void)
+{
+    Feat_Reset();
+}
+
+/*******************************************************************************
+* Function: Feat_IsActive
+* Input:    void
+* Return:   true when the mode is on and a client listens on FEATURES
+*******************************************************************************/
+bool Feat_IsActive(void)
+{
+    return featOn && Cy_BLE_GATTS_IsNotificationEnabled(&featConn, CY_BLE_LED_FEATURES_CHAR_HANDLE);
+}
+
+/*******************************************************************************
+* Function: Feat_Put
+* Input:    sample - filtered sample
+* Return:   void
+* Description:
+*    Adds a sample to the window, closing the window first if the sample is
+*    past its end. After a gap of more than a window the next one starts
+*    at the sample.
+*******************************************************************************/
+void Feat_Put(const stream_sample_t *sample)
+{
+    uint32_t ticks = (uint32_t)featWindowMs * (TS_HZ / 1000u);
+    feat_channel_t *c = &featChannel[sample->channel & (STREAM_CHANNELS - 1u)];
+    int32_t x = (int32_t)sample->value - DSP_MIDSCALE;
+    int32_t y;
+    bool above;
+
+    if(!featStarted)
+    {
+        featStart   = sample->time;
+        featStarted = true;
+    }
+    else if((sample->time - featStart) >= ticks)
+    {
+        Feat_Close();
+        featStart += ticks;
+        if((sample->time - featStart) >= ticks)
+        {
+            featStart = sample->time;
+        }
+    }
+
+    c->count++;
+    c->sum   += x;
+    c->sumSq += (uint64_t)((int64_t)x * x);
+
+    y = Dsp_Biquad(featBand, &c->band, Dsp_ToQ15(sample->value));
+    c->bandSq += (uint64_t)((int64_t)y * y);
+
+    if(c->hasBase)
+    {
+        above = ((x - c->base) > (int32_t)featThreshold) || ((c->base - x) > (int32_t)featThreshold);
+        if(above && !c->above)
+        {
+            c->crossings++;
+        }
+        c->above = above;
+    }
+}
+
+/*******************************************************************************
+* Function: Feat_Process
+* Input:    void
+* Return:   ticks until the next pass
+* Description:
+*    Called from the BLE task loop. Sends the last window, as much of it as
+*    fits the payload, and keeps the task coming back often enough to
+*    drain the ADC ring while the mode is on.
+*******************************************************************************/
+TickType_t Feat_Process(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    uint32_t payload;
+    uint32_t len;
+
+    if(!Feat_IsActive())
+    {
+        if(featStarted)
+        {
+            Feat_Reset();
+        }
+        return portMAX_DELAY;
+    }
+
+    if(featPending && (Cy_BLE_GATT_GetBusyStatus(featConn.attId) == CY_BLE_STACK_STATE_FREE))
+    {
+        payload = Conn_GetPayload(featConn.attId);
+        len     = featLen;
+        if(len > payload)
+        {
+            len = (payload < FEAT_HEADER_SIZE) ? payload :
+                  (FEAT_HEADER_SIZE + (((payload - FEAT_HEADER_SIZE) / FEAT_CHANNEL_SIZE) * FEAT_CHANNEL_SIZE));
+        }
+        if(len >= FEAT_HEADER_SIZE)
+        {
+            featValue[8] = (uint8_t)((len - FEAT_HEADER_SIZE) / FEAT_CHANNEL_SIZE);
+        }
+
+        handleValuePair.attrHandle = CY_BLE_LED_FEATURES_CHAR_HANDLE;
+        handleValuePair.value.val  = featValue;
+        handleValuePair.value.len  = (uint16_t)len;
+        if(Cy_BLE_GATTS_SendNotification(&featConn, &handleValuePair) == CY_BLE_SUCCESS)
+        {
+            featPending = false;
+        }
+    }
+    return pdMS_TO_TICKS(FEAT_POLL_MS);
+}
+
+/*******************************************************************************
+* Function: Feat_Write
+* Input:    value - the value written to the FEATURES characteristic
+* Return:   GATT error to report back to the client
+* Description:
+*    Checks and applies a configuration, layout in feat.h, and starts over.
+*    A refused write leaves the mode as it was.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Feat_Write(const cy_stc_ble_gatt_value_t *value)
+{
+    uint32_t on;
+    uint32_t windowMs;
+    uint32_t rate;
+    uint32_t low;
+    uint32_t high;
+
+    if(value->len != FEAT_CONFIG_SIZE)
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+    on       = value->val[0];
+    windowMs = value->val[1] | ((uint32_t)value->val[2] << 8u);
+    rate     = value->val[3] | ((uint32_t)value->val[4] << 8u);
+    low      = value->val[5] | ((uint32_t)value->val[6] << 8u);
+    high     = value->val[7] | ((uint32_t)value->val[8] << 8u);
+
+    if(on > 1u)
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+    if((on != 0u) && ((windowMs < FEAT_MIN_WINDOW_MS) || (windowMs > FEAT_MAX_WINDOW_MS) ||
+                      (low == 0u) || (low >= high) || ((2u * high) >= rate)))
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+
+    featOn        = (on != 0u);
+    featWindowMs  = (uint16_t)windowMs;
+    featThreshold = (uint16_t)(value->val[9] | ((uint32_t)value->val[10] << 8u));
+    if(featOn)
+    {
+        Dsp_Bandpass(featBand, low, high, rate);
+    }
+    Feat_Reset();
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/*******************************************************************************
+* Function: Feat_WriteCCCD
+* Input:    writeReqParameter - the CY_BLE_EVT_GATTS_WRITE_REQ parameter
+* Return:   GATT error to report back to the client
+* Description:
+*    Stores the FEATURES CCCD written by the client; the first window
+*    starts with the next sample.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Feat_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter)
+{
+    cy_stc_ble_gatts_db_attr_val_info_t dbAttrValInfo =
+    {
+        .handleValuePair = writeReqParameter->handleValPair,
+        .connHandle      = writeReqParameter->connHandle,
+        .flags           = CY_BLE_GATT_DB_PEER_INITIATED,
+        .offset          = 0u
+    };
+
+    featConn = writeReqParameter->connHandle;
+    Feat_Reset();
+    return Cy_BLE_GATTS_WriteAttributeValueCCCD(&dbAttrValInfo);
+}
+
+/* [] END OF FILE */
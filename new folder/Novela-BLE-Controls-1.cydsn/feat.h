@@ -0,0 +1,92 @@
+/*******************************************************************************
+* File Name: feat.h
+*
+* Version: 1.20
+*
+* Description:
+*   Feature mode, on the CM4. Instead of sending samples, the BLE task
+*   reduces each MUX channel to a few numbers per window and notifies only
+*   those: the mean, the RMS about the mean, the power in a band and the
+*   number of threshold crossings. A window of a second sends one
+*   notification where STREAM sends hundreds.
+*
+*   Samples come from the ADC (acq.h) through the filter and decimation
+*   stage (dsp.h), so its notch applies to the features too. While the mode
+*   is on and the client listens on FEATURES, the ADC runs and STREAM gets
+*   no samples. Windows are cut on the sample timestamps (ts.h), not on
+*   the RTOS tick.
+*
+*   Band power is the mean square of a second order band-pass (dsp.h)
+*   output. A threshold crossing is a sample that moves further than the
+*   threshold from the mean of the previous window, after one that did
+*   not, so a spike of either polarity counts once. Each window starts
+*   below the threshold, and the first window of a channel has no mean to
+*   measure from, so it reports 0 crossings.
+*
+*   FEATURES characteristic, little endian. Write, the configuration:
+*       [0]     1 turns the mode on, 0 off
+*       [1..2]  window, ms, FEAT_MIN_WINDOW_MS .. FEAT_MAX_WINDOW_MS
+*       [3..4]  sample rate of one MUX channel after decimation, Hz
+*       [5..6]  band, lower edge, Hz
+*       [7..8]  band, upper edge, Hz, below half the sample rate
+*       [9..10] crossing threshold, ADC codes
+*   Read and notify, the last window:
+*       [0..3]  Ts_Now() at the start of the window
+*       [4..5]  window, ms
+*       [6..7]  window sequence number
+*       [8]     n, channels that follow
+*       then n times FEAT_CHANNEL_SIZE bytes:
+*       [0]     MUX channel
+*       [1..2]  samples
+*       [3..4]  mean, ADC code
+*       [5..6]  RMS about the mean, 1/16 code
+*       [7..10] band power, 1/256 code^2
+*       [11..12] threshold crossings
+*   A notification holds the channels that fit the payload, with n
+*   counting only those; a read gets every channel that had samples in the
+*   window.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef FEAT_H
+
+    #define FEAT_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "FreeRTOS.h"
+    #include "stream.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define FEAT_CONFIG_SIZE            (11u)
+    #define FEAT_HEADER_SIZE            (9u)
+    #define FEAT_CHANNEL_SIZE           (13u)
+    #define FEAT_VALUE_SIZE             (FEAT_HEADER_SIZE + (STREAM_CHANNELS * FEAT_CHANNEL_SIZE))
+
+    #define FEAT_MIN_WINDOW_MS          (100u)
+    #define FEAT_MAX_WINDOW_MS          (60000u)
+    #define FEAT_POLL_MS                (20u)   /* BLE task pass while on; the ADC ring holds 75 ms */
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void                      Feat_Init(void);
+    bool                      Feat_IsActive(void);
+    void                      Feat_Put(const stream_sample_t *sample);
+    TickType_t                Feat_Process(void);
+    cy_en_ble_gatt_err_code_t Feat_Write(const cy_stc_ble_gatt_value_t *value);
+    cy_en_ble_gatt_err_code_t Feat_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,218 @@
+/*******************************************************************************
+* File Name: ipcring.c
+*
+* Version: 1.20
+*
+* Description:
+*   Ring buffer shared between the cores, see ipcring.h.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "ipcring.h"
+
+/*******************************************************************************
+* Function: IpcRing_Lock
+* Input:    ring - ring whose semaphore to take
+* Return:   interrupt state for IpcRing_Unlock()
+* Description:
+*    Spins on the IPC semaphore with interrupts off. The other core holds it
+*    for a few instructions with its interrupts off as well.
+*******************************************************************************/
+static uint32_t IpcRing_Lock(const ipcring_t *ring)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    while(Cy_IPC_Sema_Set(ring->sema, false) != CY_IPC_SEMA_SUCCESS)
+    {
+    }
+    return interruptState;
+}
+
+/*******************************************************************************
+* Function: IpcRing_Unlock
+* Input:    ring           - ring whose semaphore to give back
+*           interruptState - from IpcRing_Lock()
+* Return:   void
+*******************************************************************************/
+static void IpcRing_Unlock(const ipcring_t *ring, uint32_t interruptState)
+{
+    (void)Cy_IPC_Sema_Clear(ring->sema, false);
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function: IpcRing_Init
+* Input:    ring     - ring to initialize, in SRAM
+*           buf      - storage of count * size bytes, in SRAM
+*           size     - bytes per record
+*           count    - number of records, must be a power of two
+*           sema     - IPC semaphore of this ring, 16 or above
+*           doorbell - IPC interrupt structure of the consumer
+* Return:   void
+* Description:
+*    Owner side, before the ring is offered to the other core
+*******************************************************************************/
+void IpcRing_Init(ipcring_t *ring, void *buf, uint32_t size, uint32_t count,
+                  uint32_t sema, uint32_t doorbell)
+{
+    RingBuf_Init(&ring->rb, buf, size, count);
+    ring->dropped  = 0u;
+    ring->sema     = sema;
+    ring->doorbell = doorbell;
+}
+
+/*******************************************************************************
+* Function: IpcRing_Offer
+* Input:    ring         - initialized ring
+*           peerDoorbell - IPC interrupt structure of the other core
+* Return:   false if an earlier offer has not been accepted yet
+* Description:
+*    Owner side. Passes the descriptor address on IPCRING_CHAN and wakes
+*    the other core, which takes it with IpcRing_Accept().
+*******************************************************************************/
+bool IpcRing_Offer(ipcring_t *ring, uint32_t peerDoorbell)
+{
+    return Cy_IPC_Drv_SendMsgPtr(Cy_IPC_Drv_GetIpcBaseAddress(IPCRING_CHAN),
+                                 (1uL << peerDoorbell), ring) == CY_IPC_DRV_SUCCESS;
+}
+
+/*******************************************************************************
+* Function: IpcRing_Accept
+* Input:    void
+* Return:   the ring offered by the other core, NULL if there is none
+* Description:
+*    Other side. Polled until it returns a ring, e.g. after each wake up.
+*******************************************************************************/
+ipcring_t *IpcRing_Accept(void)
+{
+    IPC_STRUCT_Type *base = Cy_IPC_Drv_GetIpcBaseAddress(IPCRING_CHAN);
+    void *ring = NULL;
+
+    if(Cy_IPC_Drv_ReadMsgPtr(base, &ring) != CY_IPC_DRV_SUCCESS)
+    {
+        return NULL;
+    }
+    (void)Cy_IPC_Drv_LockRelease(base, CY_IPC_NO_NOTIFICATION);
+    return (ipcring_t *)ring;
+}
+
+/*******************************************************************************
+* Function: IpcRing_Put
+* Input:    ring - ring
+*           rec  - record of the ring's size to copy in
+* Return:   true if stored, false if the ring was full and the record dropped
+* Description:
+*    Producer side, safe from an ISR. Rings the consumer's doorbell; rings
+*    that arrive before the consumer runs fold into one interrupt.
+*******************************************************************************/
+bool IpcRing_Put(ipcring_t *ring, const void *rec)
+{
+    uint32_t interruptState;
+
+    if(!RingBuf_Put(&ring->rb, rec))
+    {
+        interruptState = IpcRing_Lock(ring);
+        ring->dropped++;
+        IpcRing_Unlock(ring, interruptState);
+        return false;
+    }
+
+    IpcRing_Ring(ring->doorbell);
+    return true;
+}
+
+/*******************************************************************************
+* Function: IpcRing_Get
+* Input:    ring - ring
+*           rec  - destination of the ring's size
+* Return:   true if a record was copied out, false if the ring was empty
+* Description:
+*    Consumer side
+*******************************************************************************/
+bool IpcRing_Get(ipcring_t *ring, void *rec)
+{
+    return RingBuf_Get(&ring->rb, rec);
+}
+
+/*******************************************************************************
+* Function: IpcRing_TakeDropped
+* Input:    ring - ring
+* Return:   records dropped since the last call
+* Description:
+*    Consumer side
+*******************************************************************************/
+uint32_t IpcRing_TakeDropped(ipcring_t *ring)
+{
+    uint32_t interruptState;
+    uint32_t dropped;
+
+    if(ring->dropped == 0u)
+    {
+        return 0u;
+    }
+
+    interruptState = IpcRing_Lock(ring);
+    dropped = ring->dropped;
+    ring->dropped = 0u;
+    IpcRing_Unlock(ring, interruptState);
+
+    return dropped;
+}
+
+/*******************************************************************************
+* Function: IpcRing_Reset
+* Input:    ring - ring
+* Return:   void
+* Description:
+*    Consumer side. Discards everything that is queued.
+*******************************************************************************/
+void IpcRing_Reset(ipcring_t *ring)
+{
+    RingBuf_Reset(&ring->rb);
+}
+
+/*******************************************************************************
+* Function: IpcRing_Ring
+* Input:    doorbell - IPC interrupt structure to raise
+* Return:   void
+*******************************************************************************/
+void IpcRing_Ring(uint32_t doorbell)
+{
+    Cy_IPC_Drv_AcquireNotify(Cy_IPC_Drv_GetIpcBaseAddress(IPCRING_CHAN), (1uL << doorbell));
+}
+
+/*******************************************************************************
+* Function: IpcRing_EnableDoorbell
+* Input:    doorbell - IPC interrupt structure of this core
+* Return:   void
+* Description:
+*    Lets IPCRING_CHAN notifications through. The caller maps the interrupt
+*    to its NVIC and clears it with IpcRing_ClearDoorbell() in the ISR.
+*******************************************************************************/
+void IpcRing_EnableDoorbell(uint32_t doorbell)
+{
+    IPC_INTR_STRUCT_Type *intr = Cy_IPC_Drv_GetIntrBaseAddr(doorbell);
+
+    Cy_IPC_Drv_ClearInterrupt(intr, CY_IPC_NO_NOTIFICATION, (1uL << IPCRING_CHAN));
+    Cy_IPC_Drv_SetInterruptMask(intr, CY_IPC_NO_NOTIFICATION, (1uL << IPCRING_CHAN));
+}
+
+/*******************************************************************************
+* Function: IpcRing_ClearDoorbell
+* Input:    doorbell - IPC interrupt structure of this core
+* Return:   void
+*******************************************************************************/
+void IpcRing_ClearDoorbell(uint32_t doorbell)
+{
+    Cy_IPC_Drv_ClearInterrupt(Cy_IPC_Drv_GetIntrBaseAddr(doorbell), CY_IPC_NO_NOTIFICATION,
+                              (1uL << IPCRING_CHAN));
+}
+
+/* [] END OF FILE */
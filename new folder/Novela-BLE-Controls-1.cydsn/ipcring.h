@@ -0,0 +1,79 @@
+/*******************************************************************************
+* File Name: ipcring.h
+*
+* Version: 1.20
+*
+* Description:
+*   Ring buffer shared between the two cores. One core produces and the
+*   other consumes. A ringbuf_t in SRAM holds the records, and both cores
+*   see it at the same address:
+*     - the owner (the core whose RAM holds the ring) calls IpcRing_Init()
+*       and hands the descriptor to the other core with IpcRing_Offer()
+*     - the other core picks it up with IpcRing_Accept()
+*     - every IpcRing_Put() rings the consumer's doorbell, an IPC interrupt
+*       structure that the consumer maps to an ISR with
+*       IpcRing_EnableDoorbell()
+*
+*   As with ringbuf_t, head and tail need no lock: each has only one
+*   writer. The drop counter has two writers, the producer counting and
+*   the consumer taking, so it is guarded by the ring's IPC semaphore.
+*
+*   Shared with both cores, no FreeRTOS calls.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef IPCRING_H
+
+    #define IPCRING_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "ringbuf.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    /* IPC channels 0..7, interrupt structures 0..7 and semaphores 0..15
+       belong to the PDL and the BLE stack */
+    #define IPCRING_CHAN                (8u)    /* descriptor hand over, doorbells */
+    #define IPCRING_INTR_CM4            (8u)    /* doorbell of the CM4             */
+    #define IPCRING_INTR_CM0            (9u)    /* doorbell of the CM0+            */
+    #define IPCRING_SEMA_STREAM         (16u)   /* STREAM sample ring              */
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef struct
+    {
+        ringbuf_t          rb;
+        volatile uint32_t  dropped;     /* records lost to a full ring, sema   */
+        uint32_t           sema;        /* IPC semaphore of this ring          */
+        uint32_t           doorbell;    /* IPC interrupt of the consumer       */
+    } ipcring_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void       IpcRing_Init(ipcring_t *ring, void *buf, uint32_t size, uint32_t count,
+                            uint32_t sema, uint32_t doorbell);
+    bool       IpcRing_Offer(ipcring_t *ring, uint32_t peerDoorbell);
+    ipcring_t *IpcRing_Accept(void);
+    bool       IpcRing_Put(ipcring_t *ring, const void *rec);
+    bool       IpcRing_Get(ipcring_t *ring, void *rec);
+    uint32_t   IpcRing_TakeDropped(ipcring_t *ring);
+    void       IpcRing_Reset(ipcring_t *ring);
+    void       IpcRing_Ring(uint32_t doorbell);
+    void       IpcRing_EnableDoorbell(uint32_t doorbell);
+    void       IpcRing_ClearDoorbell(uint32_t doorbell);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,206 @@
+/*******************************************************************************
+* File Name: lat.c
+*
+* Version: 1.20
+*
+* Description:
+*   BLE event latency histograms, see lat.h.
+*   Lat_Record() is called once per event and only does a table lookup, two
+*   count leading zeros and a few increments.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#define LOG_MODULE DIAG
+
+#include "lat.h"
+#include "log.h"
+#include <string.h>
+
+/*********************************************************************
+* Event types with their own histograms, the last one takes the rest *
+**********************************************************************/
+static const uint16_t latEvents[LAT_CLASSES] =
+{
+    CY_BLE_EVT_GATTS_WRITE_REQ,
+    CY_BLE_EVT_GATTS_WRITE_CMD_REQ,
+    CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ,
+    CY_BLE_EVT_GATTS_XCNHG_MTU_REQ,
+    CY_BLE_EVT_GAP_DEVICE_CONNECTED,
+    CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE,
+    CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,
+    CY_BLE_EVT_MAX,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   BLE task only                                                    *
+**********************************************************************/
+typedef struct
+{
+    uint32_t waitMax;
+    uint32_t runMax;
+    uint16_t wait[LAT_BINS];
+    uint16_t run[LAT_BINS];
+} lat_class_t;
+
+static lat_class_t latClasses[LAT_CLASSES];
+static uint8_t     latValue[LAT_VALUE_SIZE];
+
+/*******************************************************************************
+* Function: Lat_Bin
+* Input:    cycles - measured time
+* Return:   histogram bin
+*******************************************************************************/
+static uint32_t Lat_Bin(uint32_t cycles)
+{
+    uint32_t bits = 32u - __CLZ(cycles >> LAT_BIN_SHIFT);
+
+    return (bits < LAT_BINS) ? bits : (LAT_BINS - 1u);
+}
+
+/*******************************************************************************
+* Function: Lat_Count
+* Input:    bins   - histogram
+*           max    - longest time so far
+*           cycles - measured time
+* Return:   void
+*******************************************************************************/
+static void Lat_Count(uint16_t *bins, uint32_t *max, uint32_t cycles)
+{
+    uint32_t bin = Lat_Bin(cycles);
+
+    if(bins[bin] != 0xFFFFu)
+    {
+        bins[bin]++;
+    }
+    if(cycles > *max)
+    {
+        *max = cycles;
+    }
+}
+
+/*******************************************************************************
+* Function: Lat_Put
+* Input:    p     - where to store
+*           value - stored little endian
+*           size  - bytes
+* Return:   next free byte
+*******************************************************************************/
+static uint8_t *Lat_Put(uint8_t *p, uint32_t value, uint32_t size)
+{
+    uint32_t i;
+
+    for(i = 0u; i < size; i++)
+    {
+        *p++ = (uint8_t)(value >> (8u * i));
+    }
+    return p;
+}
+
+/*******************************************************************************
+* Function: Lat_Record
+* Input:    event - BLE event code
+*           wait  - cycles since the pass was notified, LAT_NO_WAIT if none
+*           run   - cycles in the event handler
+* Return:   void
+*******************************************************************************/
+void Lat_Record(uint32_t event, uint32_t wait, uint32_t run)
+{
+    lat_class_t *c;
+    uint32_t i;
+
+    for(i = 0u; i < (LAT_CLASSES - 1u); i++)
+    {
+        if(latEvents[i] == event)
+        {
+            break;
+        }
+    }
+    c = &latClasses[i];
+
+    if(wait != LAT_NO_WAIT)
+    {
+        Lat_Count(c->wait, &c->waitMax, wait);
+    }
+    Lat_Count(c->run, &c->runMax, run);
+}
+
+/*******************************************************************************
+* Function: Lat_Publish
+* Input:    void
+* Return:   void
+* Description:
+*    Logs the longest times and the histograms and refreshes the LATENCY
+*    value. Called with the DIAG window.
+*******************************************************************************/
+void Lat_Publish(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    const lat_class_t *c;
+    uint32_t mhz = SystemCoreClock / 1000000u;
+    uint32_t i;
+    uint32_t b;
+    uint8_t *p = latValue;
+
+    *p++ = (uint8_t)LAT_CLASSES;
+    *p++ = (uint8_t)LAT_BINS;
+    *p++ = (uint8_t)LAT_BIN_SHIFT;
+    *p++ = (uint8_t)mhz;
+
+    for(i = 0u; i < LAT_CLASSES; i++)
+    {
+        c = &latClasses[i];
+        p = Lat_Put(p, latEvents[i], 2u);
+        p = Lat_Put(p, c->waitMax, 4u);
+        p = Lat_Put(p, c->runMax, 4u);
+        for(b = 0u; b < LAT_BINS; b++)
+        {
+            p = Lat_Put(p, c->wait[b], 2u);
+        }
+        for(b = 0u; b < LAT_BINS; b++)
+        {
+            p = Lat_Put(p, c->run[b], 2u);
+        }
+
+        if(c->runMax != 0u)
+        {
+            LOG_INF("lat %lx: wait max %lu us run max %lu us\r\n", (unsigned long)latEvents[i],
+                    (unsigned long)(c->waitMax / mhz), (unsigned long)(c->runMax / mhz));
+            LOG_DBG("  wait %u %u %u %u %u %u\r\n", c->wait[0], c->wait[1], c->wait[2], c->wait[3], c->wait[4], c->wait[5]);
+            LOG_DBG("       %u %u %u %u %u %u\r\n", c->wait[6], c->wait[7], c->wait[8], c->wait[9], c->wait[10], c->wait[11]);
+            LOG_DBG("  run  %u %u %u %u %u %u\r\n", c->run[0], c->run[1], c->run[2], c->run[3], c->run[4], c->run[5]);
+            LOG_DBG("       %u %u %u %u %u %u\r\n", c->run[6], c->run[7], c->run[8], c->run[9], c->run[10], c->run[11]);
+        }
+    }
+
+    handleValuePair.attrHandle = CY_BLE_LED_LATENCY_CHAR_HANDLE;
+    handleValuePair.value.val  = latValue;
+    handleValuePair.value.len  = (uint16_t)LAT_VALUE_SIZE;
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+}
+
+/*******************************************************************************
+* Function: Lat_Write
+* Input:    value - the value written to the LATENCY characteristic, unused
+* Return:   GATT error to report back to the client
+* Description:
+*    Clears the histograms and the readable value
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Lat_Write(const cy_stc_ble_gatt_value_t *value)
+{
+    (void)value;
+
+    memset(latClasses, 0, sizeof(latClasses));
+    Lat_Publish();
+    LOG_INF("lat: cleared\r\n");
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/* [] END OF FILE */
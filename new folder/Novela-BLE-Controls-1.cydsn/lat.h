@@ -0,0 +1,67 @@
+/*******************************************************************************
+* File Name: lat.h
+*
+* Version: 1.20
+*
+* Description:
+*   BLE event latency histograms, per event type, in DWT cycles:
+*     wait  first bleInterruptNotify() of the pass -> the event is dispatched
+*           (the longest any event of that pass could have waited)
+*     run   time spent in genericEventHandler() for the event
+*   Bins are powers of two: bin 0 holds everything below 2^LAT_BIN_SHIFT
+*   cycles, bin i below 2^(LAT_BIN_SHIFT + i), the last bin everything
+*   above. At 100 MHz: 5 us, 10 us .. 5.2 ms, more.
+*
+*   Recording and publishing both run in the BLE task. The LATENCY value is
+*   refreshed with the DIAG window; any write to it clears the histograms,
+*   so a measurement run starts from zero.
+*
+*   LATENCY value, little endian:
+*       [0]     number of event types that follow, LAT_CLASSES
+*       [1]     bins per histogram, LAT_BINS
+*       [2]     LAT_BIN_SHIFT
+*       [3]     CPU clock, MHz
+*       then per event type LAT_CLASS_SIZE bytes:
+*       [0..1]  event code, CY_BLE_EVT_MAX for all others
+*       [2..5]  longest wait, cycles
+*       [6..9]  longest run, cycles
+*       [10..]  LAT_BINS wait counts, then LAT_BINS run counts, 16 bit,
+*               they stop at 0xFFFF
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef LAT_H
+
+    #define LAT_H
+
+    #include <project.h>
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define LAT_CLASSES                 (8u)
+    #define LAT_BINS                    (12u)
+    #define LAT_BIN_SHIFT               (9u)
+    #define LAT_NO_WAIT                 (0xFFFFFFFFUL)  /* event outside a pass */
+    #define LAT_HEADER_SIZE             (4u)
+    #define LAT_CLASS_SIZE              (10u + (4u * LAT_BINS))
+    #define LAT_VALUE_SIZE              (LAT_HEADER_SIZE + (LAT_CLASSES * LAT_CLASS_SIZE))
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void Lat_Record(uint32_t event, uint32_t wait, uint32_t run);
+    void Lat_Publish(void);
+    cy_en_ble_gatt_err_code_t Lat_Write(const cy_stc_ble_gatt_value_t *value);
+
+#endif
+
+/* [] END OF FILE */
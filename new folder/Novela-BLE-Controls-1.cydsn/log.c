@@ -0,0 +1,292 @@
+/*******************************************************************************
+* File Name: log.c
+*
+* Version: 1.20
+*
+* Description:
+*   Byte ring between printf() writers and the UART_1 TX FIFO interrupt.
+*   head and tail are free running counters as in ringbuf.c. The ISR is the
+*   only consumer and never takes a lock. Writers can be any task, so they
+*   reserve and fill their slot with interrupts off; that is a memcpy of one
+*   printf line, never a wait on the UART.
+*
+*   The TX level interrupt is only unmasked while the ring holds data, so an
+*   idle log costs nothing.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "log.h"
+#include <string.h>
+
+#define LOG_MASK                (LOG_RING_SIZE - 1u)
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+static char              logRing[LOG_RING_SIZE];
+static volatile uint32_t logHead = 0u;          /* writers   */
+static volatile uint32_t logTail = 0u;          /* UART ISR  */
+static volatile uint32_t logDropped = 0u;
+static uint32_t          logFifoSize = 0u;
+
+/* Build levels; the run time threshold never goes above them */
+static const uint8_t     logBuildLevel[LOG_MOD_COUNT] =
+{
+    [LOG_MOD_APP]  = LOG_LEVEL_APP,
+    [LOG_MOD_CONN] = LOG_LEVEL_CONN,
+    [LOG_MOD_CTRL] = LOG_LEVEL_CTRL,
+    [LOG_MOD_DIAG] = LOG_LEVEL_DIAG,
+    [LOG_MOD_PROF] = LOG_LEVEL_PROF,
+};
+
+volatile uint8_t         logThreshold[LOG_MOD_COUNT] =
+{
+    [LOG_MOD_APP]  = LOG_LEVEL_APP,
+    [LOG_MOD_CONN] = LOG_LEVEL_CONN,
+    [LOG_MOD_CTRL] = LOG_LEVEL_CTRL,
+    [LOG_MOD_DIAG] = LOG_LEVEL_DIAG,
+    [LOG_MOD_PROF] = LOG_LEVEL_PROF,
+};
+
+/*******************************************************************************
+* Function: Log_UartIsr
+* Input:    void
+* Return:   void
+* Description:
+*    UART_1 interrupt, replaces the component ISR (RX is polled, so the
+*    component ISR had nothing to do). Refills the TX FIFO from the ring.
+*******************************************************************************/
+static void Log_UartIsr(void)
+{
+    uint32_t tail = logTail;
+    uint32_t head = logHead;
+
+    while((tail != head) && (Cy_SCB_GetNumInTxFifo(UART_1_HW) < logFifoSize))
+    {
+        Cy_SCB_WriteTxFifo(UART_1_HW, (uint32_t)(uint8_t)logRing[tail & LOG_MASK]);
+        tail++;
+    }
+    logTail = tail;
+
+    if(tail == head)
+    {
+        Cy_SCB_SetTxInterruptMask(UART_1_HW, 0u);
+    }
+    Cy_SCB_ClearTxInterrupt(UART_1_HW, CY_SCB_TX_INTR_LEVEL);
+}
+
+/*******************************************************************************
+* Function: Log_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Takes over the UART_1 interrupt. Call right after UART_1_Start().
+*******************************************************************************/
+void Log_Init(void)
+{
+    logFifoSize = Cy_SCB_GetFifoSize(UART_1_HW);
+
+    /* Interrupt while the FIFO is less than half full */
+    Cy_SCB_SetTxFifoLevel(UART_1_HW, logFifoSize / 2u);
+    Cy_SCB_SetTxInterruptMask(UART_1_HW, 0u);
+    (void)Cy_SysInt_SetVector(UART_1_SCB_IRQ_cfg.intrSrc, &Log_UartIsr);
+    NVIC_EnableIRQ(UART_1_SCB_IRQ_cfg.intrSrc);
+}
+
+/*******************************************************************************
+* Function: Log_Write
+* Input:    text - characters to send
+*           len  - number of characters
+* Return:   len if queued, 0 if the ring was too full and the text dropped
+* Description:
+*    Never blocks. Safe from tasks and ISRs.
+*******************************************************************************/
+uint32_t Log_Write(const char *text, uint32_t len)
+{
+    uint32_t interruptState;
+    uint32_t head;
+    uint32_t slot;
+    uint32_t first;
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+
+    head = logHead;
+    if((LOG_RING_SIZE - (head - logTail)) < len)
+    {
+        logDropped++;
+        Cy_SysLib_ExitCriticalSection(interruptState);
+        return 0u;
+    }
+
+    slot  = head & LOG_MASK;
+    first = LOG_RING_SIZE - slot;
+    if(first > len)
+    {
+        first = len;
+    }
+    memcpy(&logRing[slot], text, first);
+    memcpy(&logRing[0], &text[first], len - first);
+    logHead = head + len;
+
+    Cy_SCB_SetTxInterruptMask(UART_1_HW, CY_SCB_TX_INTR_LEVEL);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+    return len;
+}
+
+/*******************************************************************************
+* Function: Log_Token
+* Input:    fmt  - format string in the .log_fmt section
+*           args - the arguments, each widened to 32 bits
+*           n    - number of arguments, LOG_MAX_ARGS at most
+* Return:   void
+* Description:
+*    Back end of LOG_PRINTF(). Builds one frame and queues it with a single
+*    Log_Write(), so a frame is never split by another writer or by a drop.
+*******************************************************************************/
+void Log_Token(const char *fmt, const uint32_t *args, uint32_t n)
+{
+    uint8_t  frame[LOG_FRAME_MAX];
+    uint32_t token = (uint32_t)(uintptr_t)fmt;
+    uint32_t len = 3u;
+    uint32_t value;
+    uint32_t i;
+
+    CY_ASSERT(n <= LOG_MAX_ARGS);
+
+    frame[0] = (uint8_t)(LOG_FRAME_MARK | n);
+    frame[1] = (uint8_t)token;
+    frame[2] = (uint8_t)(token >> 8u);
+
+    for(i = 0u; i < n; i++)
+    {
+        value = args[i];
+        while(value >= 0x80u)
+        {
+            frame[len++] = (uint8_t)(value | 0x80u);
+            value >>= 7u;
+        }
+        frame[len++] = (uint8_t)value;
+    }
+
+    (void)Log_Write((const char *)frame, len);
+}
+
+/*******************************************************************************
+* Function: Log_Flush
+* Input:    void
+* Return:   void
+* Description:
+*    Busy-waits until everything queued has left the UART. Only for fault
+*    paths and before a reset; normal code never needs it.
+*******************************************************************************/
+void Log_Flush(void)
+{
+    while(logTail != logHead)
+    {
+        if(__get_PRIMASK() != 0u)
+        {
+            /* Interrupts are off: drain by hand */
+            Log_UartIsr();
+        }
+    }
+    while(!Cy_SCB_IsTxComplete(UART_1_HW))
+    {
+    }
+}
+
+/*******************************************************************************
+* Function: Log_IsIdle
+* Input:    void
+* Return:   true when nothing is queued and the UART has sent its last bit
+* Description:
+*    The SCB stops in Deep Sleep, so the power module waits for this.
+*******************************************************************************/
+bool Log_IsIdle(void)
+{
+    return (logTail == logHead) && Cy_SCB_IsTxComplete(UART_1_HW);
+}
+
+/*******************************************************************************
+* Function: Log_GetDropped
+* Input:    void
+* Return:   number of writes lost to a full ring since power up
+*******************************************************************************/
+uint32_t Log_GetDropped(void)
+{
+    return logDropped;
+}
+
+/*******************************************************************************
+* Function: Log_UpdateLevelValue
+* Input:    void
+* Return:   void
+* Description:
+*    Keeps the readable LOGLEVEL value in line with the thresholds. Call once
+*    the BLE stack is on.
+*******************************************************************************/
+void Log_UpdateLevelValue(void)
+{
+    uint8_t levels[LOG_MOD_COUNT];
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    uint32_t i;
+
+    for(i = 0u; i < (uint32_t)LOG_MOD_COUNT; i++)
+    {
+        levels[i] = logThreshold[i];
+    }
+
+    handleValuePair.attrHandle = CY_BLE_LED_LOGLEVEL_CHAR_HANDLE;
+    handleValuePair.value.val  = levels;
+    handleValuePair.value.len  = (uint16_t)LOG_MOD_COUNT;
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+}
+
+/*******************************************************************************
+* Function: Log_WriteLevels
+* Input:    value - the value written to the LOGLEVEL characteristic
+* Return:   GATT error to report back to the client
+* Description:
+*    Sets the run time thresholds, one byte per module or one byte for all.
+*    A module cannot go above its build level; the readback shows the
+*    threshold that is in effect.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Log_WriteLevels(const cy_stc_ble_gatt_value_t *value)
+{
+    uint32_t level;
+    uint32_t i;
+
+    if((value->len == 0u) || ((value->len != 1u) && (value->len != (uint16_t)LOG_MOD_COUNT)))
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+    for(i = 0u; i < value->len; i++)
+    {
+        if(value->val[i] > LOG_LEVEL_DBG)
+        {
+            return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+        }
+    }
+
+    for(i = 0u; i < (uint32_t)LOG_MOD_COUNT; i++)
+    {
+        level = value->val[(value->len == 1u) ? 0u : i];
+        if(level > logBuildLevel[i])
+        {
+            level = logBuildLevel[i];
+        }
+        logThreshold[i] = (uint8_t)level;
+    }
+
+    Log_UpdateLevelValue();
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/* [] END OF FILE */
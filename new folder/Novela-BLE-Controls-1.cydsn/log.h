@@ -0,0 +1,185 @@
+/*******************************************************************************
+* File Name: log.h
+*
+* Version: 1.20
+*
+* Description:
+*   Non-blocking UART_1 log backend behind printf().
+*   Writers copy their text into a ring buffer and return; the UART_1 SCB
+*   TX FIFO level interrupt drains the ring. A write that does not fit is
+*   dropped as a whole and counted instead of waiting for the UART.
+*
+*   LOG_PRINTF() is the tokenized form of printf(). The format string is
+*   linked into the non-loaded .log_fmt section and only its offset goes out,
+*   followed by the arguments as varints:
+*       [0]      LOG_FRAME_MARK | number of arguments
+*       [1..2]   token, offset of the format string in .log_fmt
+*       [3..]    each argument as an unsigned LEB128 varint
+*   Plain text never has bytes of 0x80 and up, so text and frames can share
+*   the UART. tools/logdecode.py rebuilds the text from the ELF file.
+*   Arguments are integers of up to 32 bits; %s and floats are not supported
+*   (a pointer argument does not compile).
+*
+*   LOG_ERR()/LOG_WRN()/LOG_INF()/LOG_DBG() add levels on top. A source file
+*   names its module before its first #include:
+*       #define LOG_MODULE CONN
+*   and the module's build level LOG_LEVEL_CONN decides which of the four
+*   exist at all; the others expand to nothing, arguments included. The
+*   ones that are built in are filtered at run time against the module's
+*   threshold, which the client sets through the LOGLEVEL characteristic:
+*       [n]      threshold of module n (log_module_t order), LOG_LEVEL_NONE
+*                to LOG_LEVEL_DBG. A single byte sets every module.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef LOG_H
+
+    #define LOG_H
+
+    #include <project.h>
+    #include <stdbool.h>
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define LOG_RING_SIZE               (2048u) /* bytes, power of two          */
+    #define LOG_MAX_ARGS                (8u)
+    #define LOG_FRAME_MARK              (0xF0u)
+    #define LOG_FRAME_MAX               (3u + (LOG_MAX_ARGS * 5u))
+
+    #define LOG_LEVEL_NONE              (0u)
+    #define LOG_LEVEL_ERR               (1u)
+    #define LOG_LEVEL_WRN               (2u)
+    #define LOG_LEVEL_INF               (3u)
+    #define LOG_LEVEL_DBG               (4u)
+
+    /* Release builds (NDEBUG) keep warnings and errors only, so the BLE task
+       does no log work on field units. Any level can be overridden with -D */
+    #ifndef LOG_BUILD_LEVEL
+        #if defined(NDEBUG)
+            #define LOG_BUILD_LEVEL     LOG_LEVEL_WRN
+        #else
+            #define LOG_BUILD_LEVEL     LOG_LEVEL_DBG
+        #endif
+    #endif
+
+    #ifndef LOG_LEVEL_APP
+        #define LOG_LEVEL_APP           LOG_BUILD_LEVEL /* main_cm4.c       */
+    #endif
+    #ifndef LOG_LEVEL_CONN
+        #define LOG_LEVEL_CONN          LOG_BUILD_LEVEL /* conn.c           */
+    #endif
+    #ifndef LOG_LEVEL_CTRL
+        #define LOG_LEVEL_CTRL          LOG_BUILD_LEVEL /* control.c        */
+    #endif
+    #ifndef LOG_LEVEL_DIAG
+        #define LOG_LEVEL_DIAG          LOG_BUILD_LEVEL /* diag.c           */
+    #endif
+    #ifndef LOG_LEVEL_PROF
+        #define LOG_LEVEL_PROF          LOG_BUILD_LEVEL /* prof.c           */
+    #endif
+
+    /* The .log_fmt section is set up in the GCC linker script only */
+    #if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+        #define LOG_TOKENIZED           (1u)
+    #else
+        #define LOG_TOKENIZED           (0u)
+    #endif
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef enum
+    {
+        LOG_MOD_APP,
+        LOG_MOD_CONN,
+        LOG_MOD_CTRL,
+        LOG_MOD_DIAG,
+        LOG_MOD_PROF,
+        LOG_MOD_COUNT
+    } log_module_t;
+
+    /***************************************
+    *           Macros
+    ***************************************/
+    #if (LOG_TOKENIZED != 0u)
+        #define LOG_PRINTF(fmt, ...)                                                        \
+            do                                                                              \
+            {                                                                               \
+                static const char logFmt[] __attribute__((section(".log_fmt"))) = fmt;      \
+                const uint32_t logArgs[] = { 0u, ##__VA_ARGS__ };                           \
+                _Static_assert(sizeof(logArgs) <= ((LOG_MAX_ARGS + 1u) * sizeof(uint32_t)), \
+                               "LOG_PRINTF: too many arguments");                           \
+                Log_Token(logFmt, &logArgs[1], (uint32_t)(sizeof(logArgs) / sizeof(uint32_t)) - 1u); \
+            } while(0)
+    #else
+        #define LOG_PRINTF(fmt, ...)    ((void)printf(fmt, ##__VA_ARGS__))
+    #endif
+
+    #ifndef LOG_MODULE
+        #define LOG_MODULE              APP
+    #endif
+
+    #define LOG_CAT(a, b)               a##b
+    #define LOG_XCAT(a, b)              LOG_CAT(a, b)
+    #define LOG_MODULE_ID               LOG_XCAT(LOG_MOD_, LOG_MODULE)
+    #define LOG_MODULE_LEVEL            LOG_XCAT(LOG_LEVEL_, LOG_MODULE)
+
+    #define LOG_AT(level, ...)                                                              \
+        do                                                                                  \
+        {                                                                                   \
+            if((level) <= logThreshold[LOG_MODULE_ID])                                      \
+            {                                                                               \
+                LOG_PRINTF(__VA_ARGS__);                                                    \
+            }                                                                               \
+        } while(0)
+
+    #if (LOG_MODULE_LEVEL >= LOG_LEVEL_ERR)
+        #define LOG_ERR(...)            LOG_AT(LOG_LEVEL_ERR, __VA_ARGS__)
+    #else
+        #define LOG_ERR(...)            do { } while(0)
+    #endif
+    #if (LOG_MODULE_LEVEL >= LOG_LEVEL_WRN)
+        #define LOG_WRN(...)            LOG_AT(LOG_LEVEL_WRN, __VA_ARGS__)
+    #else
+        #define LOG_WRN(...)            do { } while(0)
+    #endif
+    #if (LOG_MODULE_LEVEL >= LOG_LEVEL_INF)
+        #define LOG_INF(...)            LOG_AT(LOG_LEVEL_INF, __VA_ARGS__)
+    #else
+        #define LOG_INF(...)            do { } while(0)
+    #endif
+    #if (LOG_MODULE_LEVEL >= LOG_LEVEL_DBG)
+        #define LOG_DBG(...)            LOG_AT(LOG_LEVEL_DBG, __VA_ARGS__)
+    #else
+        #define LOG_DBG(...)            do { } while(0)
+    #endif
+
+    /***************************************
+    *           Module Variables
+    ***************************************/
+    extern volatile uint8_t logThreshold[LOG_MOD_COUNT];  /* run time, per module */
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void     Log_Init(void);
+    uint32_t Log_Write(const char *text, uint32_t len);
+    void     Log_Token(const char *fmt, const uint32_t *args, uint32_t n);
+    void     Log_Flush(void);
+    uint32_t Log_GetDropped(void);
+    bool     Log_IsIdle(void);
+    void     Log_UpdateLevelValue(void);
+    cy_en_ble_gatt_err_code_t Log_WriteLevels(const cy_stc_ble_gatt_value_t *value);
+
+#endif
+
+/* [] END OF FILE */
@@ -7,6 +7,23 @@
 *   This is source code for the PSoC 6 MCU with BLE Find Me code example.
 *
 * Note:
+*   CM0+ runs the BLE controller. Between events it sleeps: Cy_BLE_Start()
+*   registers Cy_BLE_DeepSleepCallback() on this core (the host core gets
+*   Cy_BLE_SleepCallback() as well), which lets the core into Deep Sleep
+*   once BLESS is in Deep Sleep and the controller has nothing queued, and
+*   otherwise puts it in Sleep until the link layer event closes. The BLESS
+*   interrupt and the host IPC interrupt wake it again.
+*
+*   The CM4 hands over the shared STREAM ring (ipcring.h) at start up and
+*   sampleRing picks it up, but nothing on this core produces samples
+*   yet: the front end ADC sits on the I2C SCB, whose interrupt belongs
+*   to the CM4 (acq.h). A producer here calls IpcRing_Put(sampleRing, ..)
+*   once the ring has been accepted.
+*
+*   Calls from the CM4 (rpc.h) arrive on their own pipe; the pipe ISR
+*   only wakes the loop, which runs them with Rpc_Process(). While timed
+*   register steps run on the SysTick the loop uses Sleep, which keeps
+*   the SysTick counting, instead of Deep Sleep.
 *
 * Owners:
 *   peter@novelaneuro.com
@@ -22,20 +39,85 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include <stdio.h>
+#include "ipcring.h"
+#include "rpc.h"
+
+/* IPCRING_INTR_CM0 through one of the Deep Sleep capable NVIC mux inputs;
+   1 and 3 carry the BLE pipe and BLESS */
+#define IPCRING_DOORBELL_MUX        NvicMux2_IRQn
+#define IPCRING_DOORBELL_PRIORITY   3u
+
+static const cy_stc_sysint_t ipcRingIntrConfig =
+{
+    .intrSrc      = IPCRING_DOORBELL_MUX,
+    .cm0pSrc      = cpuss_interrupts_ipc_9_IRQn,    /* IPCRING_INTR_CM0 */
+    .intrPriority = IPCRING_DOORBELL_PRIORITY,
+};
+
+/* STREAM samples, owned by the CM4; NULL until it has been offered */
+static ipcring_t *sampleRing = NULL;
+
+/*******************************************************************************
+* Function: ipcRingDoorbell
+* Input:    void
+* Return:   void
+* Description:
+*    IPCRING_INTR_CM0 ISR. Only ends the sleep; the loop does the work.
+*******************************************************************************/
+static void ipcRingDoorbell(void)
+{
+    IpcRing_ClearDoorbell(IPCRING_INTR_CM0);
+}
 
 int main(void)
 {   
+    uint32_t interruptState;
+    
     __enable_irq(); /* Enable global interrupts. */
     
     Cy_BLE_Start(0);
     
+    /* Before the CM4 runs, so its ring offer wakes this core */
+    IpcRing_EnableDoorbell(IPCRING_INTR_CM0);
+    (void)Cy_SysInt_Init(&ipcRingIntrConfig, &ipcRingDoorbell);
+    NVIC_EnableIRQ(IPCRING_DOORBELL_MUX);
+    
+    /* RPC endpoint, open before the CM4 can call it */
+    Rpc_Init();
+    
     Cy_SysEnableCM4(CY_CORTEX_M4_APPL_ADDR);
    
     /* Place your initialization/startup code here (e.g. MyInst_Start()) */
     
     for(;;)
     {
-        Cy_BLE_ProcessEvents();        
+        Cy_BLE_ProcessEvents();
+        
+        if(sampleRing == NULL)
+        {
+            sampleRing = IpcRing_Accept();
+        }
+        
+        Rpc_Process();
+        
+        /* Check for work and sleep with interrupts off, so a call or ring
+           offer that arrives in between is not left for the next BLE
+           event. WFI still wakes on the pending interrupt. Fails without
+           sleeping while the controller still has work */
+        interruptState = Cy_SysLib_EnterCriticalSection();
+        if(sampleRing == NULL)
+        {
+            sampleRing = IpcRing_Accept();
+        }
+        if(Rpc_IsStepping())
+        {
+            (void)Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+        }
+        else if(!Rpc_HasPending())
+        {
+            (void)Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+        }
+        Cy_SysLib_ExitCriticalSection(interruptState);
     }
 }
 
@@ -7,19 +7,60 @@
 *           1) MUX  control WRITE
 *           1) OSC  control WRITE
 *           1) MISC control WRITE
+*           2) STREAM sample NOTIFY
+*           3) CONFIG all registers WRITE
+*           4) STATUS Write Command results NOTIFY
+*           5) SEQ  MUX scan sequence WRITE
+*           6) LOGLEVEL run time log thresholds READ/WRITE
+*           7) DIAG task CPU and stack statistics READ
+*           8) LATENCY BLE event latency histograms READ, WRITE clears
+*           9) DSP  stream filter and decimation READ/WRITE
+*          10) FEATURES window features NOTIFY, WRITE sets the mode
 *******************************************************************************/
+#define LOG_MODULE APP
+
 #include "project.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include <stdio.h>
 #include <limits.h>
+#include <string.h>
 #include "semphr.h"
 #include "timers.h"
+#include "conn.h"
+#include "stream.h"
+#include "regs.h"
+#include "status.h"
+#include "seq.h"
+#include "log.h"
+#include "power.h"
+#include "control.h"
+#include "diag.h"
+#include "lat.h"
+#include "prof.h"
+#include "rpc.h"
+#include "acq.h"
+#include "ts.h"
+#include "dsp.h"
+#include "feat.h"
 
 #define LED_ON  0UL
 #define LED_OFF 1UL
-#define HEAP_SIZE_1 8*1024
+/* Words. The Cypress BLE examples run the host in 1 K words; this task also
+   designs the DSP filters and closes feature windows, hence 2 K. DIAG shows
+   the high water mark, and configCHECK_FOR_STACK_OVERFLOW 2 traps an overflow */
+#define BLE_TASK_STACK_WORDS (2u*1024u)
 #define COUNTER_BLOCK_TIME 0
+#define BLE_TASK_PRIORITY 2   /* above CONTROL_TASK_PRIORITY */
+
+/* BLE event pump: 0 = direct to task notification, one wake drains every
+   pending event; 1 = the original counting semaphore, one wake per stack
+   callback. Kept selectable so both can be measured (blePumpStats) */
+#define BLE_PUMP_SEMAPHORE 0
+
+/* Doorbell of the rings the CM0+ fills (ipcring.h), once it has a producer */
+#define IPCRING_DOORBELL_IRQN       cpuss_interrupts_ipc_8_IRQn  /* IPCRING_INTR_CM4 */
+#define IPCRING_DOORBELL_PRIORITY   7u
 
 /********************************************************************/
 /* Default for four(4) interal registers                            */
@@ -29,6 +70,7 @@
 #define DEFAULT_OSC     0x10 /* 100-5KHz                            */
 #define DEFAULT_MUX_ON  0x01 /* MUX Disabled                        */
 #define DEFAULT_MUX_OFF 0x00 /* MUX Enabled                         */
+#define DEFAULT_SEQ     0x100 /* No CONFIG yet, any SEQ applies     */
 /********************************************************************/
 
 /*********************************************************************
@@ -38,16 +80,65 @@
 *   MUX                                                              *
 *   OSC                                                              *
 *   MISC                                                             *
+*   SEQ  sequence number of the last CONFIG write                    *
 **********************************************************************/
 uint32_t  val     = 0x00;             /*BLE-LED  written into GATT   */
 uint32_t  valPA   = DEFAULT_PA;       /*PA       written into GATT   */  
 uint32_t  valMUX  = DEFAULT_MUX;      /*MUX      written into GATT   */
 uint32_t  valOSC  = DEFAULT_OSC;      /*OSC      written into GATT   */
 uint32_t  valMISC = DEFAULT_MUX_OFF;  /*MISC     written into GATT   */
+uint32_t  valSEQ  = DEFAULT_SEQ;      /*CONFIG   sequence number     */
 /*********************************************************************/
 
+#if (BLE_PUMP_SEMAPHORE != 0)
 // This is used to lock and unlock the BLE Task
 SemaphoreHandle_t bleSemaphore;
+#endif
+
+// BLE task, woken by bleInterruptNotify()
+TaskHandle_t bleTaskHandle;
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+/*********************************************************************
+* Kernel object buffers                                              *
+*   Sized at build time, none of them comes from the heap            *
+**********************************************************************/
+static StackType_t       bleTaskStack[BLE_TASK_STACK_WORDS];
+static StaticTask_t      bleTaskTcb;
+static StackType_t       idleTaskStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t      idleTaskTcb;
+static StackType_t       timerTaskStack[configTIMER_TASK_STACK_DEPTH];
+static StaticTask_t      timerTaskTcb;
+static StaticTimer_t     xtimerBuffer;
+static StaticSemaphore_t bleSemaphorevalBuffer;
+#if (BLE_PUMP_SEMAPHORE != 0)
+static StaticSemaphore_t bleSemaphoreBuffer;
+#endif
+#endif
+
+/*********************************************************************
+* BLE event pump measurement, DWT cycles at clk_hf0                  *
+*   notifies  stack callbacks (bleInterruptNotify)                   *
+*   wakes     passes through the bleTask loop                        *
+*   latency   first callback since the last pass -> pass starts      *
+*   busy      cycles spent in the loop body                          *
+**********************************************************************/
+typedef struct
+{
+    uint32_t notifies;
+    uint32_t wakes;
+    uint32_t latencySum;
+    uint32_t latencyMax;
+    uint32_t busy;
+} ble_pump_stats_t;
+
+static ble_pump_stats_t  blePumpStats;
+static volatile uint32_t blePumpStamp;           /* first notify since the last pass start */
+static volatile bool     blePumpArmed = false;
+
+/* Stamp this pass answers, taken over at its start; bleTask owned */
+static uint32_t          blePassStamp;
+static bool              blePassArmed = false;
 
 // This is used to lock and unlock the val printf
 SemaphoreHandle_t bleSemaphoreval;
@@ -55,6 +146,12 @@ SemaphoreHandle_t bleSemaphoreval;
 // This is used to create a counter handle
 TimerHandle_t xtimer;
 
+static const cy_stc_sysint_t ipcRingIntrConfig =
+{
+    .intrSrc      = IPCRING_DOORBELL_IRQN,
+    .intrPriority = IPCRING_DOORBELL_PRIORITY,
+};
+
 /********************************************************************
   Define a callback function that will be used by timer instance.  
   The callback function does nothing but printf
@@ -67,7 +164,7 @@ TimerHandle_t xtimer;
     /* The number of times this timer has expired is saved as the
     timer's ID.  Obtain the count. */
     ulCount = ( uint32_t ) pvTimerGetTimerID( xTimer );
-    printf("%d ", ulCount);
+    LOG_DBG("%d ", ulCount);
 
     /* Increment the count, then test to see if the timer has expired */
     ulCount++;
@@ -77,11 +174,17 @@ TimerHandle_t xtimer;
         /* Do not use a block time if calling a timer API function
         from a timer callback function, as doing so could cause a
         deadlock! */
-        const char *timerName = pcTimerGetName(xtimer);
-        printf("\n(%s) expired at count: %d, \r\n", timerName , ulCount);
+        LOG_DBG("\n(Timer_1) expired at count: %d, \r\n", ulCount);
         
         /* Dump all parameters at count (10) */
-        printf("\r\nval:[%x] PA:[%x] MUX:[%x] OSC:[%x] MISC:[%x]\r\n", val, valPA, valMUX, valOSC, valMISC); 
+        LOG_INF("\r\nval:[%x] PA:[%x] MUX:[%x] OSC:[%x] MISC:[%x]\r\n", val, valPA, valMUX, valOSC, valMISC); 
+        LOG_INF("log dropped: %lu\r\n", (unsigned long)Log_GetDropped());
+        LOG_INF("deep sleeps: %lu\r\n", (unsigned long)Power_GetDeepSleeps());
+        LOG_INF("control rejected: %lu\r\n", (unsigned long)Control_GetRejected());
+        LOG_INF("BLE pump: %lu notifies %lu wakes latency avg %lu max %lu busy %lu cycles\r\n",
+                (unsigned long)blePumpStats.notifies, (unsigned long)blePumpStats.wakes,
+                (unsigned long)((blePumpStats.wakes != 0u) ? (blePumpStats.latencySum / blePumpStats.wakes) : 0u),
+                (unsigned long)blePumpStats.latencyMax, (unsigned long)blePumpStats.busy);
         
         vTimerSetTimerID( xTimer, ( void * ) 0 );
         xTimerReset( xTimer, 0 );
@@ -110,9 +213,13 @@ TimerHandle_t xtimer;
 
 void CreateTimer_1(void)
 {
-printf("Creating one RTOS timer \r\n");
+LOG_INF("Creating one RTOS timer \r\n");
 
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+xtimer = xTimerCreateStatic
+#else
 xtimer = xTimerCreate
+#endif
    ( /* Just a text name, not used by the RTOS
      kernel. */
      "Timer_1",
@@ -127,11 +234,15 @@ xtimer = xTimerCreate
      ( void * ) 0,
      /* Timer calls the same callback when it expires. */
      vTimerCallback
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+     /* Timer control block */
+     , &xtimerBuffer
+#endif
    );
                 
 if( xtimer == NULL )
      {
-         printf("The timer was not created\r\n");
+         LOG_ERR("The timer was not created\r\n");
      }
 else{
  /* Start the timer.  No block time is specified, and
@@ -139,25 +250,11 @@ else{
  scheduler has not yet been started. */
  if( xTimerStart( xtimer, 0 ) != pdPASS )
  {
-     printf("The timer could not be set into the Active state\r\n");
+     LOG_ERR("The timer could not be set into the Active state\r\n");
  }
 }
 } 
 
-/*******************************************************************************
-* Function: writeDisplayEventHandler
-* Input:    void
-* Return:   void
-* Description:
-*    This function is the BLE write to the server function - printf
-*******************************************************************************/
-
-void writeDisplayEventHandler(void)
-{
-    printf("'Semaphored' HEX Value received for the GATT Client: %x \r\n", val);
-    xSemaphoreGive(bleSemaphoreval);
-} 
-
 /*******************************************************************************
 * Function: GPIOInit_1
 * Input:    void
@@ -200,302 +297,357 @@ void GPIOInit_1(void)
 
 
 /*******************************************************************************
-* Function: writeDisplayPA
+* Function: updateConfigValue
 * Input:    void
 * Return:   void
 * Description:
-*    This function is the BLE write to PA GATT register
+*    This function keeps the readable CONFIG value in line with the registers
 *******************************************************************************/
-void writeDisplayPA(void)
-{   
-    printf("PA GATT Client: %x \r\n", valPA);
-    
-    switch (valPA)
-	{
-        case 0x00:        
-            printf("Gain:0 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-        
-        case 0x01:        
-            printf("Gain:1 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-
-        case 0x02:        
-            printf("Gain:2 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-        
-        case 0x03:        
-            printf("Gain:4 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-
-        case 0x04:        
-            printf("Gain:8 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 1UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-        
-        case 0x05:        
-            printf("Gain:16 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 1UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
+void updateConfigValue(void)
+{
+    uint8_t config[REGS_CONFIG_LEN];
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
 
-        case 0x06:        
-            printf("Gain:32 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 1UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-        
-        case 0x07:        
-            printf("Gain:64 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 1UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 0UL);
-            break;
-            
-        case 0x08:        
-            printf("Gain128 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 1UL);
-            break;
-        
-        case 0x09:        
-            printf("Gain:256 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 1UL);
-            break;
+    config[REGS_CONFIG_SEQ]                  = (uint8_t)valSEQ;
+    config[REGS_CONFIG_SEQ + 1u + REGS_PA]   = (uint8_t)valPA;
+    config[REGS_CONFIG_SEQ + 1u + REGS_MUX]  = (uint8_t)valMUX;
+    config[REGS_CONFIG_SEQ + 1u + REGS_OSC]  = (uint8_t)valOSC;
+    config[REGS_CONFIG_SEQ + 1u + REGS_MISC] = (uint8_t)valMISC;
 
-        case 0x0A:        
-            printf("Gain:512 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 1UL);
-            break;
-        
-        case 0x0B:        
-            printf("Gain:1024 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 0UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 1UL);
-            break;
+    handleValuePair.attrHandle = CY_BLE_LED_CONFIG_CHAR_HANDLE;
+    handleValuePair.value.val  = config;
+    handleValuePair.value.len  = REGS_CONFIG_LEN;
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+}
 
-        case 0x0C:        
-            printf("Gain:2048 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 0UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 0UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 1UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 1UL);
-            break;
-            
-        default:
-            printf("Gain:4096 \r\n");
-            Cy_GPIO_Write(PA0_0_PORT, PA0_0_NUM, 1UL);
-            Cy_GPIO_Write(PA1_0_PORT, PA1_0_NUM, 1UL);
-            Cy_GPIO_Write(PA2_0_PORT, PA2_0_NUM, 1UL);
-            Cy_GPIO_Write(PA3_0_PORT, PA3_0_NUM, 1UL);
-            break;            
+/*******************************************************************************
+* Function: writeDisplayPA
+* Input:    value - register code written by the client
+* Return:   GATT error to report back to the client
+* Description:
+*    This function is the BLE write to PA GATT register
+*    Gain: 0x00 -> 0, 0x01..0x0C -> 1..2048, 0x0D and up -> 4096
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t writeDisplayPA(uint32_t value)
+{   
+    if(!Control_PostValue(CONTROL_CMD_PA, value))
+    {
+        return CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
     }
+    valPA = value;
+    updateConfigValue();
+    return CY_BLE_GATT_ERR_NONE;
 }
 
 /*******************************************************************************
 * Function: writeDisplayMUX
-* Input:    void
-* Return:   void
+* Input:    value - register code written by the client
+* Return:   GATT error to report back to the client
 * Description:
 *    This function is the BLE write to MUX GATT register
+*    ON Switch: 0x00..0x0E, 0x0F and up -> Switch:F
 *******************************************************************************/
-void writeDisplayMUX(void)
+cy_en_ble_gatt_err_code_t writeDisplayMUX(uint32_t value)
 { 
-    printf("MUX GATT Client: %x \r\n", valMUX);
-    
-switch (valMUX)
-	{
-        case 0x00:        
-            printf("ON Switch:0 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL);          
-            break;
-        
-        case 0x01:        
-            printf("ON Switch:1 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-
-        case 0x02:        
-            printf("ON Switch:2 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-        
-        case 0x03:        
-            printf("ON Switch:3 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-
-        case 0x04:        
-            printf("ON Switch:4 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-        
-        case 0x05:        
-            printf("ON Switch:5 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-
-        case 0x06:        
-            printf("ON Switch:6 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-        
-        case 0x07:        
-            printf("ON Switch:7 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 0UL); 
-            break;
-            
-        case 0x08:        
-            printf("ON Switch:8 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-        
-        case 0x09:        
-            printf("ON Switch:9 \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-
-        case 0x0A:        
-            printf("ON Switch:A \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-        
-        case 0x0B:        
-            printf("ON Switch:B \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 0UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-
-        case 0x0C:        
-            printf("ON Switch:C \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-            
-        case 0x0D:        
-            printf("ON Switch:D \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-            
-        case 0x0E:        
-            printf("ON Switch:E \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 0UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;
-            
-        default:
-            printf("ON Switch:F \r\n");
-            Cy_GPIO_Write(MUX0_0_PORT, MUX0_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX1_0_PORT, MUX1_0_NUM, 1UL);
-            Cy_GPIO_Write(MUX2_0_PORT, MUX2_0_NUM, 1UL);            
-            Cy_GPIO_Write(MUX3_0_PORT, MUX3_0_NUM, 1UL); 
-            break;            
+    if(!Control_PostValue(CONTROL_CMD_MUX, value))
+    {
+        return CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
     }
+    valMUX = value;
+    updateConfigValue();
+    return CY_BLE_GATT_ERR_NONE;
 }
 
 /*******************************************************************************
 * Function: writeDisplayOSC
-* Input:    void
-* Return:   void
+* Input:    value - register code written by the client
+* Return:   GATT error to report back to the client
 * Description:
 *    This function is the BLE write to OSC GATT register
+*    OSC0..OSC2 follow bits 0..2, 0x07 and up -> all on
 *******************************************************************************/
-void writeDisplayOSC(void)
+cy_en_ble_gatt_err_code_t writeDisplayOSC(uint32_t value)
 {   
-    printf("OSC Client: %x \r\n", valOSC);
-    /* Empty for now */
-    /* Missing Case switch */
+    if(!Control_PostValue(CONTROL_CMD_OSC, value))
+    {
+        return CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+    }
+    valOSC = value;
+    updateConfigValue();
+    return CY_BLE_GATT_ERR_NONE;
 }
 
 /*******************************************************************************
 * Function: writeDisplayMISC
-* Input:    void
-* Return:   void
+* Input:    value - register code written by the client
+* Return:   GATT error to report back to the client
 * Description:
 *    This function is the BLE write to MISC GATT register
+*    MISC0..MISC3 follow bits 0..3, 0x0F and up -> all on
 *******************************************************************************/
-
-void writeDisplayMISC(void)
+cy_en_ble_gatt_err_code_t writeDisplayMISC(uint32_t value)
 {   
-    printf("MISC GATT Client: %x \r\n", valMISC);
-    /* Empty for now */
-    /* Missing Case switch */
+    if(!Control_PostValue(CONTROL_CMD_MISC, value))
+    {
+        return CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+    }
+    valMISC = value;
+    updateConfigValue();
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/*******************************************************************************
+* Function: writeDisplayCONFIG
+* Input:    value - the value written to the CONFIG characteristic
+* Return:   GATT error to report back to the client
+* Description:
+*    This function is the BLE write to all four(4) registers at once
+*    [0] SEQ, [1] PA, [2] MUX, [3] OSC, [4] MISC
+*    A write that repeats the last SEQ is a retry of a configuration that is
+*    already on the pins; it is acknowledged without touching them again.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t writeDisplayCONFIG(const cy_stc_ble_gatt_value_t *value)
+{
+    control_cmd_t cmd;
+    uint32_t i;
+
+    if(value->len != REGS_CONFIG_LEN)
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+
+    if(value->val[REGS_CONFIG_SEQ] == valSEQ)
+    {
+        LOG_DBG("CONFIG GATT Client: SEQ %x repeated \r\n", valSEQ);
+        return CY_BLE_GATT_ERR_NONE;
+    }
+
+    cmd.type = CONTROL_CMD_CONFIG;
+    for(i = 0u; i < (uint32_t)REGS_COUNT; i++)
+    {
+        cmd.arg.regs[i] = value->val[REGS_CONFIG_SEQ + 1u + i];
+    }
+    if(!Control_Post(&cmd))
+    {
+        return CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+    }
+
+    valSEQ  = value->val[REGS_CONFIG_SEQ];
+    valPA   = cmd.arg.regs[REGS_PA];
+    valMUX  = cmd.arg.regs[REGS_MUX];
+    valOSC  = cmd.arg.regs[REGS_OSC];
+    valMISC = cmd.arg.regs[REGS_MISC];
+    updateConfigValue();
+
+    LOG_DBG("CONFIG GATT Client: SEQ %x \r\n", valSEQ);
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/*******************************************************************************
+* Function: writeDisplaySTEPS
+* Input:    value - the value written to the STEPS characteristic
+* Return:   GATT error to report back to the client
+* Description:
+*    This function is the BLE write of timed register steps, layout in
+*    rpc.h. A bad list is refused here; a good one is run on the CM0+ by
+*    the control task, after any write queued before it.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t writeDisplaySTEPS(const cy_stc_ble_gatt_value_t *value)
+{
+    control_cmd_t cmd;
+    const uint8_t *p = value->val;
+    uint32_t i;
+
+    if(((value->len % RPC_STEP_SIZE) != 0u) || (value->len > (RPC_MAX_STEPS * RPC_STEP_SIZE)))
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+
+    cmd.type            = CONTROL_CMD_STEPS;
+    cmd.arg.steps.count = value->len / RPC_STEP_SIZE;
+    for(i = 0u; i < cmd.arg.steps.count; i++)
+    {
+        cmd.arg.steps.step[i].reg     = p[0];
+        cmd.arg.steps.step[i].code    = p[1];
+        cmd.arg.steps.step[i].delayUs = (uint16_t)(p[2] | ((uint16_t)p[3] << 8u));
+        p += RPC_STEP_SIZE;
+    }
+    if(!Rpc_CheckSteps(cmd.arg.steps.step, cmd.arg.steps.count))
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+
+    return Control_Post(&cmd) ? CY_BLE_GATT_ERR_NONE : CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+}
+
+/*******************************************************************************
+* Function: writeControl
+* Input:    writeReqParameter - parameter of CY_BLE_EVT_GATTS_WRITE_REQ or
+*                               CY_BLE_EVT_GATTS_WRITE_CMD_REQ
+* Return:   GATT error of the write
+* Description:
+*    This function applies a write to one of the control characteristics.
+*    Write Requests and Write Commands (no response) share it.
+*    Writes are only checked here and posted to the control task, which
+*    drives the pins; a full command queue fails the write.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t writeControl(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter)
+{
+    control_cmd_t cmd;
+    cy_en_ble_gatt_err_code_t gattErr;
+    
+    /* Any control write keeps the link on the fast CONFIG policy */
+    Conn_NoteConfig(writeReqParameter->connHandle);
+    
+    if(CY_BLE_LED_GREEN_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        /*************************************************************************/
+        /*        Read the handle and value
+         *
+         *        Attribute Value    
+         *           cy_stc_ble_gatt_value_t              value;
+         *
+         *        Attribute Handle of GATT DB
+         *           cy_ble_gatt_db_attr_handle_t         attrHandle;               
+        *************************************************************************/
+        if( xSemaphoreTake( bleSemaphoreval, (TickType_t ) 10 ) == pdTRUE)
+        {
+            val = writeReqParameter->handleValPair.value.val[0];
+            if(val>100) val = 100;
+            
+            xSemaphoreGive(bleSemaphoreval);               
+        }
+        else
+        {
+            /* We could not obtain the semaphore and can therefore not access
+            the shared resource safely. */   
+            LOG_ERR("bleSemaphoreval error\r\n");
+        }               
+        
+        if(!Control_PostValue(CONTROL_CMD_LED, val))
+        {
+            return CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+        }
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'PA' Characteristic
+     *************************************************************************/
+    if(CY_BLE_LED_PA_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return writeDisplayPA(writeReqParameter->handleValPair.value.val[0]);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'MUX' Characteristic
+     *
+     *        Stops a running sweep, in the control task
+     *************************************************************************/
+    if(CY_BLE_LED_MUX_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return writeDisplayMUX(writeReqParameter->handleValPair.value.val[0]);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'OSC' Characteristic
+     *************************************************************************/
+    if(CY_BLE_LED_OSC_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return writeDisplayOSC(writeReqParameter->handleValPair.value.val[0]);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'MISC' Characteristic
+     *************************************************************************/
+    if(CY_BLE_LED_MISC_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return writeDisplayMISC(writeReqParameter->handleValPair.value.val[0]);
+    }  
+    
+    /*************************************************************************
+     *        WRITE to the 'CONFIG' Characteristic
+     *
+     *        All four(4) registers and a sequence number in one write
+     *************************************************************************/
+    if(CY_BLE_LED_CONFIG_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return writeDisplayCONFIG(&writeReqParameter->handleValPair.value);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'SEQ' Characteristic
+     *
+     *        Channel list, dwell and repeat count; the MUX returns to the
+     *        last written MUX value when the sweep ends. Checked here, so
+     *        a bad sequence is still refused to the client, and started
+     *        by the control task after any MUX write queued before it
+     *************************************************************************/
+    if(CY_BLE_LED_SEQ_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        gattErr = Seq_Check(&writeReqParameter->handleValPair.value);
+        if(gattErr != CY_BLE_GATT_ERR_NONE)
+        {
+            return gattErr;
+        }
+        cmd.type         = CONTROL_CMD_SEQ;
+        cmd.arg.seq.idle = valMUX;
+        cmd.arg.seq.len  = writeReqParameter->handleValPair.value.len;
+        memcpy(cmd.arg.seq.data, writeReqParameter->handleValPair.value.val, cmd.arg.seq.len);
+        return Control_Post(&cmd) ? CY_BLE_GATT_ERR_NONE : CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'STEPS' Characteristic
+     *
+     *        Register codes with a wait after each, timed on the CM0+;
+     *        stops a running sweep
+     *************************************************************************/
+    if(CY_BLE_LED_STEPS_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return writeDisplaySTEPS(&writeReqParameter->handleValPair.value);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'LOGLEVEL' Characteristic
+     *
+     *        Run time log threshold per module
+     *************************************************************************/
+    if(CY_BLE_LED_LOGLEVEL_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return Log_WriteLevels(&writeReqParameter->handleValPair.value);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'LATENCY' Characteristic
+     *
+     *        Any value clears the histograms
+     *************************************************************************/
+    if(CY_BLE_LED_LATENCY_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return Lat_Write(&writeReqParameter->handleValPair.value);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'DSP' Characteristic
+     *
+     *        Notch, low-pass and decimation of the sample stream
+     *************************************************************************/
+    if(CY_BLE_LED_DSP_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return Dsp_Write(&writeReqParameter->handleValPair.value);
+    }
+    
+    /*************************************************************************
+     *        WRITE to the 'FEATURES' Characteristic
+     *
+     *        Feature mode on/off, window, band and threshold
+     *************************************************************************/
+    if(CY_BLE_LED_FEATURES_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+    {
+        return Feat_Write(&writeReqParameter->handleValPair.value);
+    }
+    
+    return CY_BLE_GATT_ERR_NONE;
 }
 
 /*******************************************************************************
@@ -510,6 +662,8 @@ void writeDisplayMISC(void)
 void genericEventHandler(uint32_t event, void *eventParameter)
 {
     cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter;
+    cy_stc_ble_gatt_err_param_t errParam;
+    cy_en_ble_gatt_err_code_t gattErr;
     uint8 i;
     
     switch (event)
@@ -524,25 +678,27 @@ void genericEventHandler(uint32_t event, void *eventParameter)
         ***********************************************************/
 		/* This event is received when the BLE stack is started */
         case CY_BLE_EVT_STACK_ON:       
-            printf("CY_BLE_EVT_STACK_ON: \r\n"); 
+            LOG_INF("CY_BLE_EVT_STACK_ON: \r\n"); 
+            Log_UpdateLevelValue();
+            Dsp_UpdateValue();
             
         case CY_BLE_EVT_GAP_DEVICE_DISCONNECTED:
             PWM_BLINK_Start();
             Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST, CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);   
             Cy_TCPWM_TriggerReloadOrIndex(PWM_DIM_HW,PWM_DIM_CNT_NUM);
             Cy_TCPWM_PWM_Disable(PWM_DIM_HW,PWM_DIM_CNT_NUM); 
-            printf("Start Advertising: \r\n");
-            printf("RED_LED is blinking till paired: \r\n");
+            LOG_INF("Start Advertising: \r\n");
+            LOG_INF("RED_LED is blinking till paired: \r\n");
             break;
             
         /* This event is received when there is a timeout */
         case CY_BLE_EVT_TIMEOUT:
-            printf("CY_BLE_EVT_TIMEOUT \r\n"); 
+            LOG_WRN("CY_BLE_EVT_TIMEOUT \r\n"); 
             break;
             
         /* This event indicates that some internal HW error has occurred */    
 		case CY_BLE_EVT_HARDWARE_ERROR: 
-            printf("CY_BLE_EVT_HARDWARE_ERROR \r\n");
+            LOG_ERR("CY_BLE_EVT_HARDWARE_ERROR \r\n");
 			break;
             
         /*  This event will be triggered by host stack if BLE stack is busy or 
@@ -552,32 +708,32 @@ void genericEventHandler(uint32_t event, void *eventParameter)
     	 *  BLE stack not busy = CYBLE_STACK_STATE_FREE 
          */
     	case CY_BLE_EVT_STACK_BUSY_STATUS:
-            printf("CY_BLE_EVT_STACK_BUSY_STATUS: %x\r\n", *(uint8 *)eventParameter);
+            LOG_DBG("CY_BLE_EVT_STACK_BUSY_STATUS: %x\r\n", *(uint8 *)eventParameter);
             break;
             
         /* This event indicates set device address command completed */
         case CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE:
-            printf("CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE \r\n");
+            LOG_DBG("CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE \r\n");
             break;
             
         /* This event indicates get device address command completed
            successfully */
         case CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE:
-            printf("CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE: ");
+            LOG_DBG("CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE: ");
             for(i = CY_BLE_GAP_BD_ADDR_SIZE; i > 0u; i--)
             {
                 /* Public Bluetooth device address of size 6 bytes in little endian format. */
-                printf("%2.2x", ((cy_stc_ble_bd_addrs_t *)((cy_stc_ble_events_param_generic_t *)eventParameter)->eventParams)->publicBdAddr[i-1]);
+                LOG_DBG("%2.2x", ((cy_stc_ble_bd_addrs_t *)((cy_stc_ble_events_param_generic_t *)eventParameter)->eventParams)->publicBdAddr[i-1]);
                 
                 /* Private Bluetooth device address of size 6 bytes in little endian format. */
-                printf("%2.2x", ((cy_stc_ble_bd_addrs_t *)((cy_stc_ble_events_param_generic_t *)eventParameter)->eventParams)->privateBdAddr[i-1]);
+                LOG_DBG("%2.2x", ((cy_stc_ble_bd_addrs_t *)((cy_stc_ble_events_param_generic_t *)eventParameter)->eventParams)->privateBdAddr[i-1]);
             }
-            printf("\r\n");          
+            LOG_DBG("\r\n");          
             break;
          
         /* This event indicates set Tx Power command completed */
         case CY_BLE_EVT_SET_TX_PWR_COMPLETE:
-            printf("CY_BLE_EVT_SET_TX_PWR_COMPLETE \r\n");
+            LOG_DBG("CY_BLE_EVT_SET_TX_PWR_COMPLETE \r\n");
             break;
                         
         /**********************************************************
@@ -587,20 +743,55 @@ void genericEventHandler(uint32_t event, void *eventParameter)
         /* This event indicates peripheral device has started/stopped
            advertising */
         case CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
-            printf("CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP: ");
+            LOG_DBG("CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP: ");
             break;
             
         /* This event is generated at the GAP Peripheral end after connection 
            is completed with peer Central device */
         case CY_BLE_EVT_GAP_DEVICE_CONNECTED:
-            printf("CY_BLE_EVT_GAP_DEVICE_CONNECTED \r\n");
+            LOG_INF("CY_BLE_EVT_GAP_DEVICE_CONNECTED \r\n");
             break;
         
         /* This event is generated at the GAP Central and the peripheral end 
            after connection parameter update is requested from the host to 
            the controller */
         case CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE:
-            printf("CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE \r\n");
+            LOG_DBG("CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE \r\n");
+            Conn_ParamUpdated((cy_stc_ble_gap_conn_param_updated_in_controller_t *)eventParameter);
+            break;
+            
+        /* This event is the central's answer to our L2CAP connection
+           parameter update request */
+        case CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP:
+            Conn_ParamResponse((cy_stc_ble_l2cap_conn_update_rsp_param_t *)eventParameter);
+            break;
+            
+        /* This event indicates the Cy_BLE_SetPhy() command completed.
+           On success CY_BLE_EVT_PHY_UPDATE_COMPLETE follows */
+        case CY_BLE_EVT_SET_PHY_COMPLETE:
+            LOG_DBG("CY_BLE_EVT_SET_PHY_COMPLETE: %x \r\n",
+                        ((cy_stc_ble_events_param_generic_t *)eventParameter)->status);
+            if(((cy_stc_ble_events_param_generic_t *)eventParameter)->status != 0u)
+            {
+                Conn_PhyUpdated((cy_stc_ble_events_param_generic_t *)eventParameter);
+            }
+            break;
+            
+        /* This event indicates the PHY of a connection changed */
+        case CY_BLE_EVT_PHY_UPDATE_COMPLETE:
+            Conn_PhyUpdated((cy_stc_ble_events_param_generic_t *)eventParameter);
+            break;
+                     
+        /* This event indicates the controller changed the LL payload
+           size (Data Length Extension) of a connection */
+        case CY_BLE_EVT_DATA_LENGTH_CHANGE:
+            Conn_DataLengthChanged((cy_stc_ble_data_length_change_event_param_t *)eventParameter);
+            break;
+            
+        /* This event indicates the Cy_BLE_SetDataLength() command completed */
+        case CY_BLE_EVT_SET_DATA_LENGTH_COMPLETE:
+            LOG_DBG("CY_BLE_EVT_SET_DATA_LENGTH_COMPLETE: %x \r\n",
+                        ((cy_stc_ble_events_param_generic_t *)eventParameter)->status);
             break;
                      
         /**********************************************************
@@ -610,10 +801,10 @@ void genericEventHandler(uint32_t event, void *eventParameter)
         /* This event is generated at the GAP Peripheral end after connection 
            is completed with peer Central device */
        case CY_BLE_EVT_GATT_CONNECT_IND:
-            printf("CY_BLE_EVT_GATT_CONNECT_IND: %x, %x \r\n", 
+            LOG_INF("CY_BLE_EVT_GATT_CONNECT_IND: %x, %x \r\n", 
                         (*(cy_stc_ble_conn_handle_t *)eventParameter).attId, 
                         (*(cy_stc_ble_conn_handle_t *)eventParameter).bdHandle);
-             printf("Active Connection Instance: %x \r\n", 
+             LOG_INF("Active Connection Instance: %x \r\n", 
                         (*(cy_stc_ble_conn_handle_t *)eventParameter).attId);
             
             /* Stop blinking LED: Client->Server connection is 'ON' */
@@ -622,12 +813,21 @@ void genericEventHandler(uint32_t event, void *eventParameter)
             
             /* Start dimming LED with default compare */ 
             PWM_DIM_Start();        
+            
+            /* Track MTU/data length and ask for the largest LL payload */
+            Conn_Open(*(cy_stc_ble_conn_handle_t *)eventParameter);
+            
+            /* Samples go to this connection once it enables notifications */
+            Stream_Start(*(cy_stc_ble_conn_handle_t *)eventParameter);
             break;
             
         /* This event is generated at the GAP Peripheral end after 
            disconnection */
         case CY_BLE_EVT_GATT_DISCONNECT_IND:
-            printf("CY_BLE_EVT_GATT_DISCONNECT_IND \r\n");
+            LOG_INF("CY_BLE_EVT_GATT_DISCONNECT_IND \r\n");
+            Conn_Close(*(cy_stc_ble_conn_handle_t *)eventParameter);
+            Stream_Stop();
+            Status_Stop();
             break;
             
         /*********************************************************************************
@@ -636,113 +836,116 @@ void genericEventHandler(uint32_t event, void *eventParameter)
          *********************************************************************************/
         case CY_BLE_EVT_GATTS_WRITE_REQ:
             
-            printf("CY_BLE_EVT_GATTS_WRITE_REQ\r\n");
+            LOG_DBG("CY_BLE_EVT_GATTS_WRITE_REQ\r\n");
             writeReqParameter = (cy_stc_ble_gatts_write_cmd_req_param_t *)eventParameter; 
+            gattErr = CY_BLE_GATT_ERR_NONE;
             
-            if(CY_BLE_LED_GREEN_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+            /*************************************************************************
+             *        WRITE to the 'STREAM' CCCD
+             *
+             *        Client enables/disables sample notifications
+             *************************************************************************/
+            if(CY_BLE_LED_STREAM_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE == writeReqParameter->handleValPair.attrHandle)
             {
-                /*************************************************************************/
-                /*        Read the handle and value
-                 *
-                 *        Attribute Value    
-                 *           cy_stc_ble_gatt_value_t              value;
-                 *
-                 *        Attribute Handle of GATT DB
-                 *           cy_ble_gatt_db_attr_handle_t         attrHandle;               
-                *************************************************************************/
-                if( xSemaphoreTake( bleSemaphoreval, (TickType_t ) 10 ) == pdTRUE)
+                if(Stream_WriteCCCD(writeReqParameter) == CY_BLE_GATT_ERR_NONE)
                 {
-                    val = writeReqParameter->handleValPair.value.val[0];
-                    if(val>100) val = 100;
-                    
-                    xSemaphoreGive(bleSemaphoreval);               
+                    LOG_INF("STREAM notifications: %x \r\n", writeReqParameter->handleValPair.value.val[0]);
                 }
-                else
-                {
-                    /* We could not obtain the semaphore and can therefore not access
-                    the shared resource safely. */   
-                    printf("bleSemaphoreval error\r\n");
-                }               
-                
-                Cy_TCPWM_PWM_SetCompare0(PWM_DIM_HW,PWM_DIM_CNT_NUM, val);
-                
-            /* printf function call */
-            xSemaphoreTake( bleSemaphoreval, (TickType_t ) 10 );
-            writeDisplayEventHandler();
             }
             
-            //Cy_BLE_GATTS_WriteRsp(writeReqParameter->connHandle);
-            /* printf function call */
-            //xSemaphoreTake( bleSemaphoreval, (TickType_t ) 10 );
-            //writeDisplayEventHandler();
-            
             /*************************************************************************
-             *        WRITE to the 'PA' Characteristic
+             *        WRITE to the 'STATUS' CCCD
              *
-             *        Do nothing, just printf() for now                
+             *        Client enables/disables Write Command results
              *************************************************************************/
-            if(CY_BLE_LED_PA_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+            else if(CY_BLE_LED_STATUS_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE == writeReqParameter->handleValPair.attrHandle)
             {
-                valPA = writeReqParameter->handleValPair.value.val[0];
-                writeDisplayPA(); /* Actual function for future use */    
+                if(Status_WriteCCCD(writeReqParameter) == CY_BLE_GATT_ERR_NONE)
+                {
+                    LOG_INF("STATUS notifications: %x \r\n", writeReqParameter->handleValPair.value.val[0]);
+                }
             }
             
             /*************************************************************************
-             *        WRITE to the 'MUX' Characteristic
+             *        WRITE to the 'TIMESTAMP' CCCD
              *
-             *        Do nothing, just printf() for now                
+             *        Client enables/disables register change timestamps
              *************************************************************************/
-            if(CY_BLE_LED_MUX_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+            else if(CY_BLE_LED_TIMESTAMP_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE == writeReqParameter->handleValPair.attrHandle)
             {
-                valMUX = writeReqParameter->handleValPair.value.val[0];
-                writeDisplayMUX(); /* Actual function for future use */  
+                if(Ts_WriteCCCD(writeReqParameter) == CY_BLE_GATT_ERR_NONE)
+                {
+                    LOG_INF("TIMESTAMP notifications: %x \r\n", writeReqParameter->handleValPair.value.val[0]);
+                }
             }
             
             /*************************************************************************
-             *        WRITE to the 'OSC' Characteristic
+             *        WRITE to the 'FEATURES' CCCD
              *
-             *        Do nothing, just printf() for now                
+             *        Client enables/disables window features
              *************************************************************************/
-            if(CY_BLE_LED_OSC_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+            else if(CY_BLE_LED_FEATURES_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE == writeReqParameter->handleValPair.attrHandle)
             {
-                valOSC = writeReqParameter->handleValPair.value.val[0];
-                writeDisplayOSC(); /* Actual function for future use */  
+                if(Feat_WriteCCCD(writeReqParameter) == CY_BLE_GATT_ERR_NONE)
+                {
+                    LOG_INF("FEATURES notifications: %x \r\n", writeReqParameter->handleValPair.value.val[0]);
+                }
             }
             
             /*************************************************************************
-             *        WRITE to the 'MISC' Characteristic
-             *
-             *        Do nothing, just printf() for now                
+             *        WRITE to the control Characteristics
              *************************************************************************/
-            if(CY_BLE_LED_MISC_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+            else
             {
-                valMISC = writeReqParameter->handleValPair.value.val[0];
-                writeDisplayMISC(); /* Actual function for future use */   
-            }  
+                gattErr = writeControl(writeReqParameter);
+            }
             
             /**************************************************************************
             * Since this is the GATT service with WRITE + response..the end of that call
             ***************************************************************************/
-            Cy_BLE_GATTS_WriteRsp(writeReqParameter->connHandle);     
+            if(gattErr == CY_BLE_GATT_ERR_NONE)
+            {
+                Cy_BLE_GATTS_WriteRsp(writeReqParameter->connHandle);
+            }
+            else
+            {
+                errParam.connHandle         = writeReqParameter->connHandle;
+                errParam.errInfo.opCode     = CY_BLE_GATT_WRITE_REQ;
+                errParam.errInfo.attrHandle = writeReqParameter->handleValPair.attrHandle;
+                errParam.errInfo.errorCode  = gattErr;
+                (void)Cy_BLE_GATTS_ErrorRsp(&errParam);
+            }
+            break;
+            
+        /*********************************************************************************
+         * This event is generated when the phone side sends a Write Command (write
+         * without response). Several can arrive in one connection event; the results
+         * go out together as one STATUS notification from the BLE task loop
+         *********************************************************************************/
+        case CY_BLE_EVT_GATTS_WRITE_CMD_REQ:
+            writeReqParameter = (cy_stc_ble_gatts_write_cmd_req_param_t *)eventParameter; 
+            gattErr = writeControl(writeReqParameter);
+            Status_Add(writeReqParameter->connHandle, writeReqParameter->handleValPair.attrHandle, gattErr);
             break;
          
         /* This event is triggered when 'GATT MTU Exchange Request' 
            received from GATT client device */
         case CY_BLE_EVT_GATTS_XCNHG_MTU_REQ:
-            printf("CY_BLE_EVT_GATTS_XCNHG_MTU_REQ \r\n");
+            LOG_DBG("CY_BLE_EVT_GATTS_XCNHG_MTU_REQ \r\n");
+            Conn_MtuExchanged((cy_stc_ble_gatt_xchg_mtu_param_t *)eventParameter);
             break;
         
         /* This event is triggered when a read received from GATT 
            client device */
         case CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
-            printf("CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ \r\n");
+            LOG_DBG("CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ \r\n");
             break;
 
         /**********************************************************
         *                       Other Events
         ***********************************************************/
         default:
-            printf("Other event: %lx \r\n", (unsigned long) event);
+            LOG_DBG("Other event: %lx \r\n", (unsigned long) event);
 			break;
 	}
 }
@@ -753,53 +956,179 @@ void genericEventHandler(uint32_t event, void *eventParameter)
  * Returns:     void
  * Description: 
  *   This is called back in the BLE ISR when an event has occured and needs to
- *   be processed.  It will then set/give the sempahore to tell the BLE task to
- *   process events.
+ *   be processed.  It will then notify the BLE task to process events. 
+ *   Notifications that arrive before the task runs fold into one wake.
 \*****************************************************************************/
 void bleInterruptNotify()
 {
     BaseType_t xHigherPriorityTaskWoken;
     xHigherPriorityTaskWoken = pdFALSE;
+    
+    blePumpStats.notifies++;
+    if(!blePumpArmed)
+    {
+        blePumpStamp = DWT->CYCCNT;
+        blePumpArmed = true;
+    }
+    
+#if (BLE_PUMP_SEMAPHORE != 0)
     xSemaphoreGiveFromISR(bleSemaphore, &xHigherPriorityTaskWoken); 
+#else
+    vTaskNotifyGiveFromISR(bleTaskHandle, &xHigherPriorityTaskWoken);
+#endif
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
+/*****************************************************************************\
+ * Function:    ipcRingDoorbell
+ * Input:       void
+ * Returns:     void
+ * Description: 
+ *   IPCRING_INTR_CM4 ISR. The CM0+ put a sample into the shared STREAM
+ *   ring; wake the BLE task, which moves it over in Stream_Process().
+\*****************************************************************************/
+static void ipcRingDoorbell(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    
+    IpcRing_ClearDoorbell(IPCRING_INTR_CM4);
+    
+#if (BLE_PUMP_SEMAPHORE != 0)
+    /* Created by the task itself */
+    if(bleSemaphore != NULL)
+    {
+        xSemaphoreGiveFromISR(bleSemaphore, &xHigherPriorityTaskWoken); 
+    }
+#else
+    vTaskNotifyGiveFromISR(bleTaskHandle, &xHigherPriorityTaskWoken);
+#endif
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/*****************************************************************************\
+ * Function:    bleEventDispatch
+ * Input:       CY_BLE Event Handler event and eventParameter
+ * Returns:     void
+ * Description: 
+ *   Registered with the stack in place of genericEventHandler() to time
+ *   each event: the wait since the pass was notified and the time in the
+ *   handler go into the latency histograms (lat.c)
+\*****************************************************************************/
+static void bleEventDispatch(uint32_t event, void *eventParameter)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t wait  = blePassArmed ? (start - blePassStamp) : LAT_NO_WAIT;
+    
+    genericEventHandler(event, eventParameter);
+    Lat_Record(event, wait, DWT->CYCCNT - start);
+}
+
+/*****************************************************************************\
+ * Function:    blePumpBegin
+ * Input:       void
+ * Returns:     DWT->CYCCNT at the start of the pass
+ * Description: 
+ *   Takes over the notify stamp for this pass and disarms it, in one step
+ *   with reading the start time. A notify during the pass stamps afresh
+ *   and is measured by the next pass; a pass woken by a timeout has no
+ *   stamp and measures nothing.
+\*****************************************************************************/
+static uint32_t blePumpBegin(void)
+{
+    uint32_t start;
+    
+    taskENTER_CRITICAL();
+    blePassArmed = blePumpArmed;
+    blePassStamp = blePumpStamp;
+    blePumpArmed = false;
+    start = DWT->CYCCNT;
+    taskEXIT_CRITICAL();
+    
+    return start;
+}
+
+/*****************************************************************************\
+ * Function:    blePumpMeasure
+ * Input:       start - blePumpBegin() of the pass
+ * Returns:     void
+ * Description: 
+ *   Adds one pass of the bleTask loop to blePumpStats
+\*****************************************************************************/
+static void blePumpMeasure(uint32_t start)
+{
+    uint32_t latency;
+    
+    blePumpStats.wakes++;
+    blePumpStats.busy += DWT->CYCCNT - start;
+    
+    if(blePassArmed)
+    {
+        latency = start - blePassStamp;
+        blePassArmed = false;
+        blePumpStats.latencySum += latency;
+        if(latency > blePumpStats.latencyMax)
+        {
+            blePumpStats.latencyMax = latency;
+        }
+    }
+}
+
 /*****************************************************************************\
  * Function:    bleTask
  * Input:       A FreeRTOS Task - void * that is unused
  * Returns:     void
  * Description: 
- *  This task starts the BLE stack... and processes events when the bleSempahore
- *  is set by the ISR.
+ *  This task starts the BLE stack... and processes events when the ISR
+ *  notifies it.
 \*****************************************************************************/
 void bleTask(void *arg)
 {
+    TickType_t wait = portMAX_DELAY;
+    TickType_t diagWait;
+    TickType_t profWait;
+    TickType_t acqWait;
+    TickType_t tsWait;
+    TickType_t featWait;
+    uint32_t   start;
+    
     (void)arg;
     
-    printf("BLE Task Started\r\n");
+    LOG_INF("BLE Task Started\r\n");
     
+#if (BLE_PUMP_SEMAPHORE != 0)
     /******************************************************************
     * Create a counting semaphore that has a maximum count of 10 and an
     initial count of 0. 
     *******************************************************************/
     /*                                      max     ,intial           */
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    bleSemaphore = xSemaphoreCreateCountingStatic(UINT_MAX,0,&bleSemaphoreBuffer);
+#else
     bleSemaphore = xSemaphoreCreateCounting(UINT_MAX,0);
+#endif
+#endif
     
     /* Simple semaphore for the 'val' printf */
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    bleSemaphoreval = xSemaphoreCreateMutexStatic(&bleSemaphorevalBuffer);
+#else
     bleSemaphoreval = xSemaphoreCreateMutex();
+#endif
     
+#if (BLE_PUMP_SEMAPHORE != 0)
     /* The semaphore was created successfully. */
     if(bleSemaphore != NULL) {
-        printf("'bleSemaphore' was created successfully \r\n");      
+        LOG_INF("'bleSemaphore' was created successfully \r\n");      
     }
+#endif
     
     /* The val printf semaphore was created successfully. */
     if(bleSemaphoreval != NULL) {
-        printf("'bleSemaphoreval' was created successfully \r\n");      
+        LOG_INF("'bleSemaphoreval' was created successfully \r\n");      
     }
     
     
-    Cy_BLE_Start(genericEventHandler);
+    Cy_BLE_Start(bleEventDispatch);
     
     while (Cy_BLE_GetState() != CY_BLE_STATE_ON)
     {
@@ -810,19 +1139,102 @@ void bleTask(void *arg)
     
     for(;;)
     {
-        xSemaphoreTake(bleSemaphore, portMAX_DELAY);
+#if (BLE_PUMP_SEMAPHORE != 0)
+        xSemaphoreTake(bleSemaphore, wait);
+#else
+        /* Clears every notification given so far: one pass for all of them */
+        (void)ulTaskNotifyTake(pdTRUE, wait);
+#endif
+        start = blePumpBegin();
         Cy_BLE_ProcessEvents();   
+        Stream_Process();
+        Status_Process();
+        
+        /* Wake up again when the connection policy may change and, while
+           streaming, at least every STREAM_FLUSH_MS so a partly filled
+           frame does not wait for the next BLE event */
+        wait = Conn_Process(Stream_IsActive());
+        if(Stream_IsActive() && (wait > pdMS_TO_TICKS(STREAM_FLUSH_MS)))
+        {
+            wait = pdMS_TO_TICKS(STREAM_FLUSH_MS);
+        }
+        diagWait = Diag_Process();
+        if(wait > diagWait)
+        {
+            wait = diagWait;
+        }
+        profWait = Prof_Process();
+        if(wait > profWait)
+        {
+            wait = profWait;
+        }
+        acqWait = Acq_Process(Stream_IsActive() || Feat_IsActive());
+        if(wait > acqWait)
+        {
+            wait = acqWait;
+        }
+        tsWait = Ts_Process();
+        if(wait > tsWait)
+        {
+            wait = tsWait;
+        }
+        featWait = Feat_Process();
+        if(wait > featWait)
+        {
+            wait = featWait;
+        }
+        blePumpMeasure(start);
     }   
 }
 
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+/*****************************************************************************\
+ * Function:    vApplicationGetIdleTaskMemory
+ * Input:       ppxIdleTaskTCBBuffer, ppxIdleTaskStackBuffer, pulIdleTaskStackSize
+ * Returns:     void
+ * Description: 
+ *   Hands the idle task its control block and stack, called by
+ *   vTaskStartScheduler()
+\*****************************************************************************/
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer   = &idleTaskTcb;
+    *ppxIdleTaskStackBuffer = idleTaskStack;
+    *pulIdleTaskStackSize   = configMINIMAL_STACK_SIZE;
+}
+
+/*****************************************************************************\
+ * Function:    vApplicationGetTimerTaskMemory
+ * Input:       ppxTimerTaskTCBBuffer, ppxTimerTaskStackBuffer, pulTimerTaskStackSize
+ * Returns:     void
+ * Description: 
+ *   Hands the timer service task its control block and stack, called by
+ *   vTaskStartScheduler()
+\*****************************************************************************/
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer   = &timerTaskTcb;
+    *ppxTimerTaskStackBuffer = timerTaskStack;
+    *pulTimerTaskStackSize   = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
 int main(void)
 {
     __enable_irq(); /* Enable global interrupts. */  
     
     UART_1_Start();
+    Log_Init();     /* LOG_PRINTF() never waits on the UART from here on */
     setvbuf( stdin, NULL, _IONBF, 0 );
     setvbuf( stdout, NULL, _IONBF, 0 );
-    printf("System Started Succesfully.\r\n");
+    LOG_INF("System Started Succesfully.\r\n");
+    
+    /* Time base for samples and register changes, before the first write */
+    Ts_Init();
     
     /* Start two PWMs */
     PWM_DIM_Start();
@@ -834,10 +1246,47 @@ int main(void)
     ***************************/
     GPIOInit_1();
     
+    /* Sample ring for the STREAM characteristic */
+    Stream_Init();
+    Acq_Init();     /* I2C ADC, runs while STREAM is listened to */
+    Dsp_Init();
+    Feat_Init();    /* off until a FEATURES write */
+    
+    /* MUX scan sequencer counter, stopped until a SEQ write */
+    Seq_Init();
+    Power_Init();   /* tickless idle on MCWDT0 */
+    
+    /* Pins, PWM and sequencer are driven from the control task */
+    Control_Init();
+    
+    /* Activity counters per scenario, reported on UART_1 */
+    Prof_Init();
+    
+    /* Calls into the CM0+, whose endpoint is already open */
+    Rpc_Init();
+    
     /* Create one counter and call vTimerCallback */ 
     CreateTimer_1();
     
-    xTaskCreate(bleTask,"bleTask",HEAP_SIZE_1,0,2,0);
+    /* Cycle counter for the BLE pump measurement */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    bleTaskHandle = xTaskCreateStatic(bleTask,"bleTask",BLE_TASK_STACK_WORDS,0,BLE_TASK_PRIORITY,bleTaskStack,&bleTaskTcb);
+#else
+    xTaskCreate(bleTask,"bleTask",BLE_TASK_STACK_WORDS,0,BLE_TASK_PRIORITY,&bleTaskHandle);
+#endif
+    
+    /* Hand the shared STREAM ring to the CM0+, its doorbell wakes bleTask */
+    IpcRing_EnableDoorbell(IPCRING_INTR_CM4);
+    (void)Cy_SysInt_Init(&ipcRingIntrConfig, &ipcRingDoorbell);
+    NVIC_EnableIRQ(IPCRING_DOORBELL_IRQN);
+    if(!IpcRing_Offer(Stream_GetSharedRing(), IPCRING_INTR_CM0))
+    {
+        LOG_ERR("The STREAM ring was not handed to the CM0+\r\n");
+    }
     
     vTaskStartScheduler();
     
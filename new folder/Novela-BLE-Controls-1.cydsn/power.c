@@ -0,0 +1,237 @@
+/*******************************************************************************
+* File Name: power.c
+*
+* Version: 1.20
+*
+* Description:
+*   Tickless idle on MCWDT0 counter 0, see power.h.
+*   Power_Sleep() runs in the idle task with the scheduler suspended and
+*   PRIMASK set, so the interrupt that ends the sleep is only served after
+*   the tick count has been stepped.
+*
+*   Time during the sleep is measured in clk_lf counts. The part of a tick
+*   that is left over is carried to the next sleep, so the RTOS time does
+*   not drift against the WCO however often the CPU sleeps.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "power.h"
+#include "seq.h"
+#include "acq.h"
+#include "log.h"
+#include "ts.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+static void Power_WakeIsr(void);
+static cy_en_syspm_status_t Power_DeepSleepCheck(cy_stc_syspm_callback_params_t *callbackParams,
+                                                 cy_en_syspm_callback_mode_t mode);
+
+/*********************************************************************
+* MCWDT and power mode configuration                                 *
+**********************************************************************/
+static const cy_stc_mcwdt_config_t powerMcwdtConfig =
+{
+    .c0Match        = 0u,
+    .c1Match        = 0u,
+    .c0Mode         = CY_MCWDT_MODE_INT,
+    .c1Mode         = CY_MCWDT_MODE_NONE,
+    .c2ToggleBit    = 0u,
+    .c2Mode         = CY_MCWDT_MODE_NONE,
+    .c0ClearOnMatch = false,
+    .c1ClearOnMatch = false,
+    .c0c1Cascade    = false,
+    .c1c2Cascade    = false,
+};
+
+static const cy_stc_sysint_t powerIntrConfig =
+{
+    .intrSrc      = POWER_MCWDT_IRQN,
+    .intrPriority = POWER_INTR_PRIORITY,
+};
+
+static cy_stc_syspm_callback_params_t powerCallbackParams = { .base = NULL };
+
+static cy_stc_syspm_callback_t powerClockCallback =
+{
+    .callback       = &Cy_SysClk_DeepSleepCallback,
+    .type           = CY_SYSPM_DEEPSLEEP,
+    .skipMode       = 0u,
+    .callbackParams = &powerCallbackParams,
+};
+
+static cy_stc_syspm_callback_t powerCheckCallback =
+{
+    .callback       = &Power_DeepSleepCheck,
+    .type           = CY_SYSPM_DEEPSLEEP,
+    .skipMode       = CY_SYSPM_SKIP_CHECK_FAIL | CY_SYSPM_SKIP_BEFORE_TRANSITION |
+                      CY_SYSPM_SKIP_AFTER_TRANSITION,
+    .callbackParams = &powerCallbackParams,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   Idle task only                                                   *
+**********************************************************************/
+static uint32_t powerResidue = 0u;      /* clk_lf counts * tick rate, < POWER_LF_HZ */
+static uint32_t powerDeepSleeps = 0u;
+
+/*******************************************************************************
+* Function: Power_WakeIsr
+* Input:    void
+* Return:   void
+* Description:
+*    MCWDT match: the idle time is over. Only wakes the CPU.
+*******************************************************************************/
+static void Power_WakeIsr(void)
+{
+    Cy_MCWDT_ClearInterrupt(POWER_MCWDT_HW, POWER_MCWDT_CTR_MASK);
+}
+
+/*******************************************************************************
+* Function: Power_DeepSleepCheck
+* Input:    callbackParams - unused
+*           mode           - power mode transition step
+* Return:   CY_SYSPM_FAIL while something needs the high frequency clocks
+* Description:
+*    Deep Sleep callback, CY_SYSPM_CHECK_READY only
+*******************************************************************************/
+static cy_en_syspm_status_t Power_DeepSleepCheck(cy_stc_syspm_callback_params_t *callbackParams,
+                                                 cy_en_syspm_callback_mode_t mode)
+{
+    (void)callbackParams;
+
+    if((mode == CY_SYSPM_CHECK_READY) && (Seq_IsRunning() || Acq_IsRunning() || !Log_IsIdle()))
+    {
+        return CY_SYSPM_FAIL;
+    }
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+* Function: Power_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Starts the MCWDT counter and registers the Deep Sleep callbacks.
+*    Call before the scheduler.
+*******************************************************************************/
+void Power_Init(void)
+{
+    (void)Cy_MCWDT_Init(POWER_MCWDT_HW, &powerMcwdtConfig);
+    Cy_MCWDT_SetInterruptMask(POWER_MCWDT_HW, POWER_MCWDT_CTR_MASK);
+    Cy_MCWDT_Enable(POWER_MCWDT_HW, POWER_MCWDT_CTR_MASK, POWER_MCWDT_WAIT_US);
+
+    (void)Cy_SysInt_Init(&powerIntrConfig, &Power_WakeIsr);
+    NVIC_EnableIRQ(POWER_MCWDT_IRQN);
+
+    /* FLL/PLL are restored on wake by the SysClk driver */
+    (void)Cy_SysPm_RegisterCallback(&powerClockCallback);
+    (void)Cy_SysPm_RegisterCallback(&powerCheckCallback);
+}
+
+/*******************************************************************************
+* Function: Power_Sleep
+* Input:    idleTicks - ticks until the next task is due, 2 and up
+* Return:   void
+* Description:
+*    portSUPPRESS_TICKS_AND_SLEEP(). Sleeps for at most idleTicks - 1 ticks;
+*    the SysTick then restarts with a full period, so the due task runs on
+*    its tick. Any other interrupt ends the sleep early. After a Deep
+*    Sleep the time base gets the clk_lf time that its counter missed.
+*******************************************************************************/
+void Power_Sleep(uint32_t idleTicks)
+{
+    uint32_t interruptState;
+    uint32_t start;
+    uint32_t tsStart;
+    uint32_t slept;
+    uint32_t lost;
+    uint32_t counted;
+    uint32_t total;
+    uint32_t ticks;
+    bool deepSleep = false;
+
+    if(idleTicks > POWER_MAX_IDLE_TICKS)
+    {
+        idleTicks = POWER_MAX_IDLE_TICKS;
+    }
+
+    /* PRIMASK only: a pending interrupt still ends WFI */
+    interruptState = Cy_SysLib_EnterCriticalSection();
+
+    if(eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        Cy_SysLib_ExitCriticalSection(interruptState);
+        return;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    /* The match takes a few clk_lf cycles to apply; one tick is 32 of them */
+    start   = Cy_MCWDT_GetCount(POWER_MCWDT_HW, POWER_MCWDT_CTR);
+    tsStart = Ts_Now();
+    Cy_MCWDT_ClearInterrupt(POWER_MCWDT_HW, POWER_MCWDT_CTR_MASK);
+    NVIC_ClearPendingIRQ(POWER_MCWDT_IRQN);
+    Cy_MCWDT_SetMatch(POWER_MCWDT_HW, POWER_MCWDT_CTR,
+                      (start + (((idleTicks - 1u) * POWER_LF_HZ) / configTICK_RATE_HZ)) & POWER_LF_MASK, 0u);
+
+    /* The BLE callback refuses Deep Sleep while BLESS cannot follow */
+    if((idleTicks >= POWER_DEEPSLEEP_MIN_TICKS) &&
+       (Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT) == CY_SYSPM_SUCCESS))
+    {
+        powerDeepSleeps++;
+        deepSleep = true;
+    }
+    else
+    {
+        (void)Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+    }
+
+    slept = (Cy_MCWDT_GetCount(POWER_MCWDT_HW, POWER_MCWDT_CTR) - start) & POWER_LF_MASK;
+
+    /* The time base counted around the Deep Sleep, not through it */
+    if(deepSleep)
+    {
+        lost    = (uint32_t)(((uint64_t)slept * TS_HZ) / POWER_LF_HZ);
+        counted = Ts_Now() - tsStart;
+        if(lost > counted)
+        {
+            Ts_Advance(lost - counted);
+        }
+    }
+
+    /* Tick compensation from the clk_lf time actually slept */
+    total = (slept * configTICK_RATE_HZ) + powerResidue;
+    ticks = total / POWER_LF_HZ;
+    powerResidue = total % POWER_LF_HZ;
+    if(ticks > (idleTicks - 1u))
+    {
+        ticks = idleTicks - 1u;
+    }
+
+    SysTick->VAL = 0u;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    vTaskStepTick(ticks);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function: Power_GetDeepSleeps
+* Input:    void
+* Return:   number of times the CM4 was in Deep Sleep since power up
+*******************************************************************************/
+uint32_t Power_GetDeepSleeps(void)
+{
+    return powerDeepSleeps;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,62 @@
+/*******************************************************************************
+* File Name: power.h
+*
+* Version: 1.20
+*
+* Description:
+*   Tickless idle for the CM4. FreeRTOSConfig.h maps
+*   portSUPPRESS_TICKS_AND_SLEEP() to Power_Sleep(), which stops the SysTick,
+*   arms MCWDT0 counter 0 (clk_lf, WCO) for the idle time and puts the CPU
+*   into Deep Sleep when the BLE stack and the blockers below allow it, or
+*   into Sleep otherwise. The tick count is stepped on wake from the
+*   MCWDT count, which keeps running in Deep Sleep, and so is the ts.h
+*   time base, whose TCPWM counter does not.
+*
+*   Deep Sleep is refused while a MUX sweep runs (TCPWM stops in Deep Sleep)
+*   or while the log is still going out on UART_1.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef POWER_H
+
+    #define POWER_H
+
+    #include <project.h>
+    #include "mcwdt/cy_mcwdt.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    /* The MCWDT component in TopDesign is not placed, so MCWDT0 is driven
+       directly. Counter 0 free runs over 16 bits and only its match
+       interrupt is used, as the wake up source */
+    #define POWER_MCWDT_HW              MCWDT_STRUCT0
+    #define POWER_MCWDT_CTR             CY_MCWDT_COUNTER0
+    #define POWER_MCWDT_CTR_MASK        CY_MCWDT_CTR0
+    #define POWER_MCWDT_IRQN            srss_interrupt_mcwdt_0_IRQn
+    #define POWER_INTR_PRIORITY         (7u)    /* wake up only, does no work   */
+
+    #define POWER_LF_HZ                 (32768u)            /* clk_lf = WCO     */
+    #define POWER_LF_MASK               (0xFFFFu)           /* 16 bit counter   */
+    #define POWER_MAX_IDLE_TICKS        (1500u)             /* < 2 s wrap       */
+    #define POWER_DEEPSLEEP_MIN_TICKS   (4u)    /* shorter idle: Sleep only     */
+    #define POWER_MCWDT_WAIT_US         (93u)   /* 3 clk_lf cycles              */
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void     Power_Init(void);
+    void     Power_Sleep(uint32_t idleTicks);
+    uint32_t Power_GetDeepSleeps(void);
+
+#endif
+
+/* [] END OF FILE */
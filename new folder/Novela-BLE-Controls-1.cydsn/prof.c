@@ -0,0 +1,264 @@
+/*******************************************************************************
+* File Name: prof.c
+*
+* Version: 1.20
+*
+* Description:
+*   Energy profile, see prof.h.
+*   Prof_Process() runs on every BLE task pass, which owns the connection
+*   and STREAM state the scenario is taken from.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#define LOG_MODULE PROF
+
+#include "prof.h"
+#include "log.h"
+#include "seq.h"
+#include "stream.h"
+#include "task.h"
+#include "profile/cy_profile.h"
+
+#if (PROF_ENABLE != 0u)
+
+/*********************************************************************
+* Profile counters, in prof_ctr_t order                              *
+**********************************************************************/
+typedef struct
+{
+    en_ep_mon_sel_t          monitor;
+    cy_en_profile_duration_t duration;
+    uint32_t                 weight;
+} prof_counter_config_t;
+
+static const prof_counter_config_t profCounters[PROF_CTR_COUNT] =
+{
+    [PROF_CTR_ACTIVE]   = { PROFILE_ONE,              CY_PROFILE_DURATION, PROF_WEIGHT_ACTIVE   },
+    [PROF_CTR_CM4]      = { CPUSS_MONITOR_CM4,        CY_PROFILE_DURATION, PROF_WEIGHT_CM4      },
+    [PROF_CTR_CM0]      = { CPUSS_MONITOR_CM0,        CY_PROFILE_DURATION, PROF_WEIGHT_CM0      },
+    [PROF_CTR_FLASH]    = { CPUSS_MONITOR_FLASH,      CY_PROFILE_EVENT,    PROF_WEIGHT_FLASH    },
+    [PROF_CTR_UART]     = { SCB5_MONITOR_AHB,         CY_PROFILE_EVENT,    PROF_WEIGHT_UART     },
+    [PROF_CTR_I2C]      = { SCB6_MONITOR_AHB,         CY_PROFILE_EVENT,    PROF_WEIGHT_I2C      },
+    [PROF_CTR_RADIO_TX] = { BLESS_EXT_PA_TX_CTL_OUT,  CY_PROFILE_DURATION, PROF_WEIGHT_RADIO_TX },
+    [PROF_CTR_RADIO_RX] = { BLESS_EXT_LNA_RX_CTL_OUT, CY_PROFILE_DURATION, PROF_WEIGHT_RADIO_RX },
+};
+
+static const cy_stc_sysint_t profIntrConfig =
+{
+    .intrSrc      = profile_interrupt_IRQn,
+    .intrPriority = PROF_INTR_PRIORITY,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   BLE task only                                                    *
+**********************************************************************/
+typedef struct
+{
+    uint32_t windows;
+    uint64_t ms;                        /* wall time of those windows   */
+    uint64_t raw[PROF_CTR_COUNT];
+    uint64_t weighted;
+} prof_total_t;
+
+static cy_stc_profile_ctr_ptr_t profCtr[PROF_CTR_COUNT];
+static prof_total_t             profTotals[PROF_SCN_COUNT];
+static prof_scenario_t          profScenario = PROF_SCN_OTHER;
+static bool                     profMixed = false;  /* scenario changed in the window */
+static TickType_t               profStart = 0u;
+static uint32_t                 profWindows = 0u;
+static uint32_t                 profDropped = 0u;
+
+/*******************************************************************************
+* Function: Prof_Scenario
+* Input:    void
+* Return:   what the device is doing now
+*******************************************************************************/
+static prof_scenario_t Prof_Scenario(void)
+{
+    if(Seq_IsRunning())
+    {
+        return PROF_SCN_SWEEPING;
+    }
+    if(Stream_IsActive())
+    {
+        return PROF_SCN_STREAMING;
+    }
+    if(Cy_BLE_GetNumOfActiveConn() != 0u)
+    {
+        return PROF_SCN_CONNECTED;
+    }
+    if(Cy_BLE_GetAdvertisementState() == CY_BLE_ADV_STATE_ADVERTISING)
+    {
+        return PROF_SCN_ADVERTISING;
+    }
+    return PROF_SCN_OTHER;
+}
+
+/*******************************************************************************
+* Function: Prof_Rate
+* Input:    count - counts over ms milliseconds
+*           ms    - wall time
+* Return:   counts per second, 0xFFFFFFFF if it does not fit
+*******************************************************************************/
+static uint32_t Prof_Rate(uint64_t count, uint64_t ms)
+{
+    uint64_t rate = (ms != 0u) ? ((count * 1000u) / ms) : 0u;
+
+    return (rate > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)rate;
+}
+
+/*******************************************************************************
+* Function: Prof_Report
+* Input:    void
+* Return:   void
+* Description:
+*    Logs the per second rates of every scenario seen since power up
+*******************************************************************************/
+static void Prof_Report(void)
+{
+    const prof_total_t *t;
+    uint32_t hfHz = cy_Hfclk0FreqHz;
+    uint32_t awake;
+    uint32_t s;
+
+    LOG_INF("prof: %lu windows dropped\r\n", (unsigned long)profDropped);
+
+    for(s = 0u; s < (uint32_t)PROF_SCN_COUNT; s++)
+    {
+        t = &profTotals[s];
+        if(t->windows == 0u)
+        {
+            continue;
+        }
+
+        /* 1/1000 of the wall time the chip was awake */
+        awake = (hfHz != 0u) ? Prof_Rate(t->raw[PROF_CTR_ACTIVE], t->ms) / (hfHz / 1000u) : 0u;
+
+        LOG_INF("prof %lu: %lu windows awake %lu.%lu%% weighted %lu/s\r\n",
+                (unsigned long)s, (unsigned long)t->windows,
+                (unsigned long)(awake / 10u), (unsigned long)(awake % 10u),
+                (unsigned long)Prof_Rate(t->weighted, t->ms));
+        LOG_INF("  cm4 %lu cm0 %lu flash %lu uart %lu /s\r\n",
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_CM4], t->ms),
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_CM0], t->ms),
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_FLASH], t->ms),
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_UART], t->ms));
+        LOG_INF("  i2c %lu tx %lu rx %lu /s\r\n",
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_I2C], t->ms),
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_RADIO_TX], t->ms),
+                (unsigned long)Prof_Rate(t->raw[PROF_CTR_RADIO_RX], t->ms));
+    }
+}
+
+/*******************************************************************************
+* Function: Prof_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Sets up the counters and starts the first window. Call before the
+*    scheduler.
+*******************************************************************************/
+void Prof_Init(void)
+{
+    uint32_t i;
+
+    Cy_Profile_Init();
+    Cy_Profile_ClearConfiguration();
+
+    for(i = 0u; i < (uint32_t)PROF_CTR_COUNT; i++)
+    {
+        profCtr[i] = Cy_Profile_ConfigureCounter(profCounters[i].monitor, profCounters[i].duration,
+                                                 CY_PROFILE_CLK_HF, profCounters[i].weight);
+        (void)Cy_Profile_EnableCounter(profCtr[i]);
+    }
+
+    (void)Cy_SysInt_Init(&profIntrConfig, &Cy_Profile_ISR);
+    NVIC_EnableIRQ(profile_interrupt_IRQn);
+
+    Cy_Profile_StartProfiling();
+}
+
+/*******************************************************************************
+* Function: Prof_Process
+* Input:    void
+* Return:   ticks until the window ends
+* Description:
+*    Called from the BLE task loop on every pass once the stack is on.
+*    Notes a scenario change, and when the window is due closes it, files
+*    it unless the scenario changed and starts the next one.
+*******************************************************************************/
+TickType_t Prof_Process(void)
+{
+    TickType_t      now = xTaskGetTickCount();
+    TickType_t      elapsed = now - profStart;
+    prof_scenario_t scenario;
+    prof_total_t   *t;
+    uint64_t        count;
+    uint32_t        i;
+
+    scenario = Prof_Scenario();
+    if(scenario != profScenario)
+    {
+        profMixed = true;
+    }
+
+    if(elapsed < pdMS_TO_TICKS(PROF_WINDOW_MS))
+    {
+        return pdMS_TO_TICKS(PROF_WINDOW_MS) - elapsed;
+    }
+
+    Cy_Profile_StopProfiling();
+
+    if(!profMixed)
+    {
+        t = &profTotals[scenario];
+        t->windows++;
+        t->ms += (uint64_t)elapsed * portTICK_PERIOD_MS;
+        for(i = 0u; i < (uint32_t)PROF_CTR_COUNT; i++)
+        {
+            (void)Cy_Profile_GetRawCount(profCtr[i], &count);
+            t->raw[i] += count;
+        }
+        t->weighted += Cy_Profile_GetSumWeightedCounts(profCtr, PROF_CTR_COUNT);
+    }
+    else
+    {
+        profDropped++;
+    }
+
+    profScenario = scenario;
+    profMixed    = false;
+    profStart    = now;
+    Cy_Profile_ClearCounters();
+    Cy_Profile_StartProfiling();
+
+    if(++profWindows >= PROF_REPORT_WINDOWS)
+    {
+        profWindows = 0u;
+        Prof_Report();
+    }
+    return pdMS_TO_TICKS(PROF_WINDOW_MS);
+}
+
+#else
+
+void Prof_Init(void)
+{
+}
+
+TickType_t Prof_Process(void)
+{
+    return portMAX_DELAY;
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* File Name: prof.h
+*
+* Version: 1.20
+*
+* Description:
+*   Energy profile. The PDL energy profiler counts eight activity sources
+*   over windows of PROF_WINDOW_MS; each window is filed under the scenario
+*   the device was in throughout. The scenario is sampled on every BLE task
+*   pass, and a window in which any sample differed is dropped; a change
+*   that comes and goes between two passes is not seen. Every
+*   PROF_REPORT_WINDOWS windows the per second rates and the weighted sum
+*   per scenario are logged on UART_1, so two builds can be compared
+*   scenario by scenario.
+*
+*   The profiler only counts while the chip is active: PROF_CTR_ACTIVE
+*   against the window length gives the awake share, the rest was spent in
+*   Deep Sleep.
+*
+*   Weights are the energy of one count, in any unit that is the same for
+*   all counters. They are 1 until calibrated against a supply measurement,
+*   which makes the weighted sum a plain activity count.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef PROF_H
+
+    #define PROF_H
+
+    #include <project.h>
+    #include "FreeRTOS.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    /* The report is logged at INF, which Release builds leave out. To
+       profile a Release build add -DPROF_ENABLE=1 -DLOG_LEVEL_PROF=3 */
+    #ifndef PROF_ENABLE
+        #if defined(NDEBUG)
+            #define PROF_ENABLE         (0u)
+        #else
+            #define PROF_ENABLE         (1u)
+        #endif
+    #endif
+    #ifndef PROF_WINDOW_MS
+        #define PROF_WINDOW_MS          (1000u)
+    #endif
+    #define PROF_REPORT_WINDOWS         (10u)
+    #define PROF_INTR_PRIORITY          (7u)    /* counter overflow only    */
+
+    /* Energy of one count, see above */
+    #ifndef PROF_WEIGHT_ACTIVE
+        #define PROF_WEIGHT_ACTIVE      (1u)    /* clk_hf cycle, chip awake */
+        #define PROF_WEIGHT_CM4         (1u)    /* clk_hf cycle, CM4 active */
+        #define PROF_WEIGHT_CM0         (1u)    /* clk_hf cycle, CM0 active */
+        #define PROF_WEIGHT_FLASH       (1u)    /* flash read               */
+        #define PROF_WEIGHT_UART        (1u)    /* SCB5 (UART_1) access     */
+        #define PROF_WEIGHT_I2C         (1u)    /* SCB6 (I2C) access        */
+        #define PROF_WEIGHT_RADIO_TX    (1u)    /* clk_hf cycle, radio TX   */
+        #define PROF_WEIGHT_RADIO_RX    (1u)    /* clk_hf cycle, radio RX   */
+    #endif
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef enum
+    {
+        PROF_CTR_ACTIVE = 0u,
+        PROF_CTR_CM4,
+        PROF_CTR_CM0,
+        PROF_CTR_FLASH,
+        PROF_CTR_UART,
+        PROF_CTR_I2C,
+        PROF_CTR_RADIO_TX,
+        PROF_CTR_RADIO_RX,
+        PROF_CTR_COUNT
+    } prof_ctr_t;
+
+    typedef enum
+    {
+        PROF_SCN_OTHER = 0u,        /* not advertising, not connected   */
+        PROF_SCN_ADVERTISING,
+        PROF_SCN_CONNECTED,         /* connected, no STREAM, no sweep   */
+        PROF_SCN_STREAMING,
+        PROF_SCN_SWEEPING,          /* MUX sweep, streaming or not      */
+        PROF_SCN_COUNT
+    } prof_scenario_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void       Prof_Init(void);
+    TickType_t Prof_Process(void);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,211 @@
+/*******************************************************************************
+* File Name: regs.c
+*
+* Version: 1.20
+*
+* Description:
+*   Table driven register -> GPIO port update.
+*   Bit n of a register code drives pin <REG>n, wherever the fitter placed it
+*   (PA0 is bit 0 but sits on P9[3]). The tables hold the resulting port bits
+*   for every code and are expanded from the cyfitter pin numbers by the
+*   preprocessor, so a pin move in the .cydwr only needs a rebuild.
+*
+*   PA and OSC share port 9. The update toggles only the pins of one register
+*   through OUT_INV, so the other register on the port is never disturbed.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "regs.h"
+
+/*********************************************************************
+* Pin patterns                                                       *
+**********************************************************************/
+#define REGS_BIT(code, n, pin)  ((((uint32_t)(code) >> (n)) & 1UL) << (pin))
+
+#define REGS_PA_PINS(code)      (REGS_BIT(code, 0u, PA0_0_NUM)   | REGS_BIT(code, 1u, PA1_0_NUM) | \
+                                 REGS_BIT(code, 2u, PA2_0_NUM)   | REGS_BIT(code, 3u, PA3_0_NUM))
+#define REGS_MUX_PINS(code)     (REGS_BIT(code, 0u, MUX0_0_NUM)  | REGS_BIT(code, 1u, MUX1_0_NUM) | \
+                                 REGS_BIT(code, 2u, MUX2_0_NUM)  | REGS_BIT(code, 3u, MUX3_0_NUM))
+#define REGS_OSC_PINS(code)     (REGS_BIT(code, 0u, OSC0_0_NUM)  | REGS_BIT(code, 1u, OSC1_0_NUM) | \
+                                 REGS_BIT(code, 2u, OSC2_0_NUM))
+#define REGS_MISC_PINS(code)    (REGS_BIT(code, 0u, MISC0_0_NUM) | REGS_BIT(code, 1u, MISC1_0_NUM) | \
+                                 REGS_BIT(code, 2u, MISC2_0_NUM) | REGS_BIT(code, 3u, MISC3_0_NUM))
+
+#define REGS_CODES_0_7(F)       F(0u), F(1u), F(2u), F(3u), F(4u), F(5u), F(6u), F(7u)
+#define REGS_CODES_8_15(F)      F(8u), F(9u), F(10u), F(11u), F(12u), F(13u), F(14u), F(15u)
+
+/* Gain:0 .. Gain:2048 are the binary code, anything above is Gain:4096 */
+static const uint32_t regsPaPins[REGS_PA_MAX_CODE + 1u] =
+{
+    REGS_CODES_0_7(REGS_PA_PINS),
+    REGS_PA_PINS(8u), REGS_PA_PINS(9u), REGS_PA_PINS(10u), REGS_PA_PINS(11u), REGS_PA_PINS(12u),
+    REGS_PA_PINS(15u)
+};
+
+static const uint32_t regsMuxPins[REGS_MUX_MAX_CODE + 1u] =
+{
+    REGS_CODES_0_7(REGS_MUX_PINS), REGS_CODES_8_15(REGS_MUX_PINS)
+};
+
+static const uint32_t regsOscPins[REGS_OSC_MAX_CODE + 1u] =
+{
+    REGS_CODES_0_7(REGS_OSC_PINS)
+};
+
+static const uint32_t regsMiscPins[REGS_MISC_MAX_CODE + 1u] =
+{
+    REGS_CODES_0_7(REGS_MISC_PINS), REGS_CODES_8_15(REGS_MISC_PINS)
+};
+
+/*********************************************************************
+* Register map                                                       *
+*   MUX_EN (P5[6]) shares the MUX port but is not part of the mask   *
+**********************************************************************/
+typedef struct
+{
+    GPIO_PRT_Type  *port;
+    uint32_t        mask;       /* all pins of the register     */
+    const uint32_t *pins;       /* port bits per code           */
+    uint32_t        maxCode;
+} regs_map_t;
+
+static const regs_map_t regsMap[REGS_COUNT] =
+{
+    /* PA   */ { PA0_0_PORT,   REGS_PA_PINS(0xFu),   regsPaPins,   REGS_PA_MAX_CODE   },
+    /* MUX  */ { MUX0_0_PORT,  REGS_MUX_PINS(0xFu),  regsMuxPins,  REGS_MUX_MAX_CODE  },
+    /* OSC  */ { OSC0_0_PORT,  REGS_OSC_PINS(0x7u),  regsOscPins,  REGS_OSC_MAX_CODE  },
+    /* MISC */ { MISC0_0_PORT, REGS_MISC_PINS(0xFu), regsMiscPins, REGS_MISC_MAX_CODE },
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   Written with interrupts off, next to the port write              *
+**********************************************************************/
+static regs_change_t regsChange[REGS_COUNT];
+
+/*******************************************************************************
+* Function: Regs_Record
+* Input:    reg  - register that changed
+*           code - code now on its pins
+*           time - Ts_Now() at the port write
+* Return:   void
+* Description:
+*    Interrupts must be off
+*******************************************************************************/
+static void Regs_Record(uint32_t reg, uint32_t code, uint32_t time)
+{
+    regsChange[reg].time = time;
+    regsChange[reg].code = (uint8_t)code;
+    regsChange[reg].count++;
+}
+
+/*******************************************************************************
+* Function: Regs_Write
+* Input:    reg   - register to update
+*           value - register code, clamped to the highest code of the register
+* Return:   void
+* Description:
+*    Drives all pins of the register with one port write. Constant time, no
+*    printf; callers log the value themselves.
+*******************************************************************************/
+void Regs_Write(regs_id_t reg, uint32_t value)
+{
+    const regs_map_t *map;
+    uint32_t code;
+    uint32_t interruptState;
+
+    CY_ASSERT(reg < REGS_COUNT);
+
+    map  = &regsMap[reg];
+    code = (value > map->maxCode) ? map->maxCode : value;
+
+    /* The critical section only keeps the read of OUT and the toggle
+       together; the pins change at the same instant on the OUT_INV write */
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    GPIO_PRT_OUT_INV(map->port) = (GPIO_PRT_OUT(map->port) & map->mask) ^ map->pins[code];
+    Regs_Record(reg, code, Ts_Now());
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function: Regs_WriteAll
+* Input:    value - code of every register, indexed by regs_id_t
+* Return:   void
+* Description:
+*    Applies a whole front end configuration in one step. Registers that
+*    share a port are merged, so each port is written once, and all port
+*    writes run back to back with interrupts off.
+*******************************************************************************/
+void Regs_WriteAll(const uint32_t value[REGS_COUNT])
+{
+    GPIO_PRT_Type *port[REGS_COUNT];
+    uint32_t mask[REGS_COUNT];
+    uint32_t pins[REGS_COUNT];
+    uint32_t code[REGS_COUNT];
+    uint32_t ports = 0u;
+    uint32_t interruptState;
+    uint32_t time;
+    uint32_t reg;
+    uint32_t i;
+
+    for(reg = 0u; reg < (uint32_t)REGS_COUNT; reg++)
+    {
+        code[reg] = (value[reg] > regsMap[reg].maxCode) ? regsMap[reg].maxCode : value[reg];
+
+        i = 0u;
+        while((i < ports) && (port[i] != regsMap[reg].port))
+        {
+            i++;
+        }
+        if(i == ports)
+        {
+            port[i] = regsMap[reg].port;
+            mask[i] = 0u;
+            pins[i] = 0u;
+            ports++;
+        }
+        mask[i] |= regsMap[reg].mask;
+        pins[i] |= regsMap[reg].pins[code[reg]];
+    }
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    for(i = 0u; i < ports; i++)
+    {
+        GPIO_PRT_OUT_INV(port[i]) = (GPIO_PRT_OUT(port[i]) & mask[i]) ^ pins[i];
+    }
+    time = Ts_Now();
+    for(reg = 0u; reg < (uint32_t)REGS_COUNT; reg++)
+    {
+        Regs_Record(reg, code[reg], time);
+    }
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function: Regs_GetChange
+* Input:    reg    - register
+*           change - destination
+* Return:   void
+* Description:
+*    Consistent copy of the last change, safe against a write from an ISR.
+*    Each core keeps its own: writes made on the CM0+ are not seen here.
+*******************************************************************************/
+void Regs_GetChange(regs_id_t reg, regs_change_t *change)
+{
+    uint32_t interruptState;
+
+    CY_ASSERT(reg < REGS_COUNT);
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    *change = regsChange[reg];
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/* [] END OF FILE */
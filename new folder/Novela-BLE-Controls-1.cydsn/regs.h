@@ -0,0 +1,74 @@
+/*******************************************************************************
+* File Name: regs.h
+*
+* Version: 1.20
+*
+* Description:
+*   The four(4) internal registers (PA, MUX, OSC, MISC) and the GPIO pins that
+*   drive the analog front end. Every register value is looked up in a table
+*   built at compile time from the pin map and lands on its port in a single
+*   write, so the front end never sees an intermediate gain or channel code.
+*   Each write records the time the pins switched (ts.h), so clients can
+*   line gain and channel changes up with the samples.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef REGS_H
+
+    #define REGS_H
+
+    #include <project.h>
+    #include "ts.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    /* Highest code with its own pin pattern; larger values clamp to it */
+    #define REGS_PA_MAX_CODE            (13u)   /* 13 = Gain:4096, all pins on */
+    #define REGS_MUX_MAX_CODE           (15u)   /* Switch:F                    */
+    #define REGS_OSC_MAX_CODE           (7u)
+    #define REGS_MISC_MAX_CODE          (15u)
+
+    /* CONFIG characteristic: [0] sequence, [1] PA, [2] MUX, [3] OSC, [4] MISC */
+    #define REGS_CONFIG_SEQ             (0u)
+    #define REGS_CONFIG_LEN             (1u + REGS_COUNT)
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef enum
+    {
+        REGS_PA = 0u,
+        REGS_MUX,
+        REGS_OSC,
+        REGS_MISC,
+        REGS_COUNT
+    } regs_id_t;
+
+    /* Last change of one register */
+    typedef struct
+    {
+        uint32_t time;          /* Ts_Now() when the pins switched          */
+        uint16_t count;         /* changes since power up, wraps            */
+        uint8_t  code;          /* code on the pins, after clamping         */
+        uint8_t  reserved;
+    } regs_change_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void Regs_Write(regs_id_t reg, uint32_t value);
+    void Regs_WriteAll(const uint32_t value[REGS_COUNT]);
+    void Regs_GetChange(regs_id_t reg, regs_change_t *change);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,131 @@
+/*******************************************************************************
+* File Name: rice.c
+*
+* Version: 1.20
+*
+* Description:
+*   Rice coder, see rice.h.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "rice.h"
+
+/*******************************************************************************
+* Function: Rice_Parameter
+* Input:    sum   - sum of the zigzag residuals seen
+*           count - number of them
+* Return:   k for residuals with that mean, about log2(mean)
+*******************************************************************************/
+uint32_t Rice_Parameter(uint32_t sum, uint32_t count)
+{
+    uint32_t k = 0u;
+
+    while((k < RICE_MAX_K) && ((count << (k + 1u)) <= sum))
+    {
+        k++;
+    }
+    return k;
+}
+
+/*******************************************************************************
+* Function: Rice_Bits
+* Input:    zz - zigzag residual
+*           k  - parameter
+* Return:   bits Rice_Put() takes for it
+*******************************************************************************/
+uint32_t Rice_Bits(uint32_t zz, uint32_t k)
+{
+    uint32_t q = zz >> k;
+
+    return (q < RICE_ESCAPE) ? (q + 1u + k) : (RICE_ESCAPE + RICE_RAW_BITS);
+}
+
+/*******************************************************************************
+* Function: Rice_Begin
+* Input:    w        - writer
+*           buf      - destination
+*           capBytes - size of buf
+* Return:   void
+*******************************************************************************/
+void Rice_Begin(rice_writer_t *w, uint8_t *buf, uint32_t capBytes)
+{
+    w->buf     = buf;
+    w->capBits = capBytes * 8u;
+    w->bits    = 0u;
+}
+
+/*******************************************************************************
+* Function: Rice_PutBits
+* Input:    w     - writer
+*           value - bits to append, low n bits
+*           n     - 0 .. 32
+* Return:   void
+* Description:
+*    Appends MSB first, a byte at a time
+*******************************************************************************/
+void Rice_PutBits(rice_writer_t *w, uint32_t value, uint32_t n)
+{
+    uint32_t used;
+    uint32_t take;
+    uint8_t *p;
+
+    CY_ASSERT((w->bits + n) <= w->capBits);
+
+    while(n != 0u)
+    {
+        p    = &w->buf[w->bits >> 3u];
+        used = w->bits & 7u;
+        take = ((8u - used) < n) ? (8u - used) : n;
+
+        if(used == 0u)
+        {
+            *p = 0u;
+        }
+        *p |= (uint8_t)(((value >> (n - take)) & ((1uL << take) - 1u)) << (8u - used - take));
+
+        w->bits += take;
+        n       -= take;
+    }
+}
+
+/*******************************************************************************
+* Function: Rice_Put
+* Input:    w  - writer with Rice_Bits(zz, k) bits of room
+*           zz - zigzag residual, below 2^RICE_RAW_BITS
+*           k  - parameter
+* Return:   void
+*******************************************************************************/
+void Rice_Put(rice_writer_t *w, uint32_t zz, uint32_t k)
+{
+    uint32_t q = zz >> k;
+
+    if(q >= RICE_ESCAPE)
+    {
+        Rice_PutBits(w, (1uL << RICE_ESCAPE) - 1u, RICE_ESCAPE);
+        Rice_PutBits(w, zz, RICE_RAW_BITS);
+        return;
+    }
+
+    /* q ones and the closing zero */
+    Rice_PutBits(w, (1uL << (q + 1u)) - 2u, q + 1u);
+    Rice_PutBits(w, zz, k);
+}
+
+/*******************************************************************************
+* Function: Rice_End
+* Input:    w - writer
+* Return:   bytes used, the last one padded with zeros
+*******************************************************************************/
+uint32_t Rice_End(const rice_writer_t *w)
+{
+    return (w->bits + 7u) >> 3u;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* File Name: rice.h
+*
+* Version: 1.20
+*
+* Description:
+*   Rice coder for the compressed STREAM frames (stream.h). Signed
+*   residuals are zigzag mapped (0, -1, 1, -2 .. -> 0, 1, 2, 3 ..) and sent
+*   as a quotient in unary (ones ended by a zero) and k low bits. A quotient
+*   of RICE_ESCAPE or more is sent as RICE_ESCAPE ones and the value in
+*   RICE_RAW_BITS bits, so one bad residual costs 33 bits at most.
+*
+*   Bits are packed MSB first. The writer never goes past its buffer: the
+*   caller asks Rice_Bits() first and stops when the next value would not
+*   fit. tools/streamdecode.py is the matching decoder.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef RICE_H
+
+    #define RICE_H
+
+    #include <project.h>
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define RICE_MAX_K                  (15u)   /* fits 4 bits                  */
+    #define RICE_ESCAPE                 (16u)   /* quotient sent raw from here  */
+    #define RICE_RAW_BITS               (17u)   /* zigzag of a 16 bit difference */
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef struct
+    {
+        uint8_t  *buf;
+        uint32_t  capBits;
+        uint32_t  bits;         /* written so far                           */
+    } rice_writer_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    /*******************************************************************************
+    * Function: Rice_ZigZag
+    * Input:    v - signed residual
+    * Return:   v mapped to 0, 1, 2 .. by magnitude
+    *******************************************************************************/
+    __STATIC_INLINE uint32_t Rice_ZigZag(int32_t v)
+    {
+        return ((uint32_t)v << 1u) ^ (uint32_t)(v >> 31u);
+    }
+
+    uint32_t Rice_Parameter(uint32_t sum, uint32_t count);
+    uint32_t Rice_Bits(uint32_t zz, uint32_t k);
+    void     Rice_Begin(rice_writer_t *w, uint8_t *buf, uint32_t capBytes);
+    void     Rice_PutBits(rice_writer_t *w, uint32_t value, uint32_t n);
+    void     Rice_Put(rice_writer_t *w, uint32_t zz, uint32_t k);
+    uint32_t Rice_End(const rice_writer_t *w);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,195 @@
+/*******************************************************************************
+* File Name: ringbuf.c
+*
+* Version: 1.20
+*
+* Description:
+*   Lock-free single-producer / single-consumer ring buffer.
+*   head and tail are free running counters; the record slot is the counter
+*   masked with (count - 1). The data memory barrier orders the record copy
+*   against the index update so the other side never sees a half written slot.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "ringbuf.h"
+#include <string.h>
+
+/*******************************************************************************
+* Function: RingBuf_Init
+* Input:    rb    - ring to initialize
+*           buf   - storage of count * size bytes
+*           size  - bytes per record
+*           count - number of records, must be a power of two
+* Return:   void
+* Description:
+*    This function binds the storage to the ring and empties it
+*******************************************************************************/
+void RingBuf_Init(ringbuf_t *rb, void *buf, uint32_t size, uint32_t count)
+{
+    CY_ASSERT((count != 0u) && ((count & (count - 1u)) == 0u));
+
+    rb->buf  = (uint8_t *)buf;
+    rb->size = size;
+    rb->mask = count - 1u;
+    rb->head = 0u;
+    rb->tail = 0u;
+}
+
+/*******************************************************************************
+* Function: RingBuf_Put
+* Input:    rb  - ring
+*           rec - record of rb->size bytes to copy in
+* Return:   true if stored, false if the ring was full
+* Description:
+*    Producer side. Safe to call from an ISR.
+*******************************************************************************/
+bool RingBuf_Put(ringbuf_t *rb, const void *rec)
+{
+    uint32_t head = rb->head;
+
+    if((head - rb->tail) > rb->mask)
+    {
+        return false;
+    }
+
+    memcpy(&rb->buf[(head & rb->mask) * rb->size], rec, rb->size);
+    __DMB();
+    rb->head = head + 1u;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function: RingBuf_Get
+* Input:    rb  - ring
+*           rec - destination of rb->size bytes
+* Return:   true if a record was copied out, false if the ring was empty
+* Description:
+*    Consumer side.
+*******************************************************************************/
+bool RingBuf_Get(ringbuf_t *rb, void *rec)
+{
+    void *slot = RingBuf_Peek(rb);
+
+    if(slot == NULL)
+    {
+        return false;
+    }
+
+    memcpy(rec, slot, rb->size);
+    RingBuf_Drop(rb);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function: RingBuf_Peek
+* Input:    rb - ring
+* Return:   pointer to the oldest record, NULL if the ring is empty
+* Description:
+*    Consumer side. The slot stays owned by the consumer until RingBuf_Drop().
+*******************************************************************************/
+void *RingBuf_Peek(ringbuf_t *rb)
+{
+    uint32_t tail = rb->tail;
+
+    if(rb->head == tail)
+    {
+        return NULL;
+    }
+
+    __DMB();
+    return &rb->buf[(tail & rb->mask) * rb->size];
+}
+
+/*******************************************************************************
+* Function: RingBuf_PeekAt
+* Input:    rb    - ring
+*           index - 0 for the oldest record
+* Return:   pointer to the record, NULL if fewer are waiting
+* Description:
+*    Consumer side. Lets the consumer look ahead before it commits to a
+*    number of records with RingBuf_Skip().
+*******************************************************************************/
+void *RingBuf_PeekAt(ringbuf_t *rb, uint32_t index)
+{
+    uint32_t tail = rb->tail;
+
+    if((rb->head - tail) <= index)
+    {
+        return NULL;
+    }
+
+    __DMB();
+    return &rb->buf[((tail + index) & rb->mask) * rb->size];
+}
+
+/*******************************************************************************
+* Function: RingBuf_Drop
+* Input:    rb - ring
+* Return:   void
+* Description:
+*    Consumer side. Releases the record returned by RingBuf_Peek().
+*******************************************************************************/
+void RingBuf_Drop(ringbuf_t *rb)
+{
+    __DMB();
+    rb->tail = rb->tail + 1u;
+}
+
+/*******************************************************************************
+* Function: RingBuf_Skip
+* Input:    rb - ring
+*           n  - records to release, no more than RingBuf_Count()
+* Return:   void
+* Description:
+*    Consumer side. Releases the n oldest records.
+*******************************************************************************/
+void RingBuf_Skip(ringbuf_t *rb, uint32_t n)
+{
+    CY_ASSERT(n <= RingBuf_Count(rb));
+
+    __DMB();
+    rb->tail = rb->tail + n;
+}
+
+/*******************************************************************************
+* Function: RingBuf_Count
+* Input:    rb - ring
+* Return:   number of records waiting for the consumer
+*******************************************************************************/
+uint32_t RingBuf_Count(const ringbuf_t *rb)
+{
+    return rb->head - rb->tail;
+}
+
+/*******************************************************************************
+* Function: RingBuf_Free
+* Input:    rb - ring
+* Return:   number of records the producer can still store
+*******************************************************************************/
+uint32_t RingBuf_Free(const ringbuf_t *rb)
+{
+    return (rb->mask + 1u) - (rb->head - rb->tail);
+}
+
+/*******************************************************************************
+* Function: RingBuf_Reset
+* Input:    rb - ring
+* Return:   void
+* Description:
+*    Consumer side. Discards everything that is queued.
+*******************************************************************************/
+void RingBuf_Reset(ringbuf_t *rb)
+{
+    rb->tail = rb->head;
+}
+
+/* [] END OF FILE */
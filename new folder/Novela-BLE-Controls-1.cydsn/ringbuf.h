@@ -0,0 +1,56 @@
+/*******************************************************************************
+* File Name: ringbuf.h
+*
+* Version: 1.20
+*
+* Description:
+*   Single-producer / single-consumer ring buffer of fixed-size records.
+*   The producer (ISR or task) only moves 'head', the consumer only moves
+*   'tail', so no lock is needed between the two sides.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef RINGBUF_H
+
+    #define RINGBUF_H
+
+    #include <project.h>
+    #include <stdbool.h>
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef struct
+    {
+        uint8_t           *buf;      /* storage: count * size bytes           */
+        uint32_t           size;     /* bytes per record                      */
+        uint32_t           mask;     /* count - 1, count is a power of two    */
+        volatile uint32_t  head;     /* free running, written by producer     */
+        volatile uint32_t  tail;     /* free running, written by consumer     */
+    } ringbuf_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void     RingBuf_Init(ringbuf_t *rb, void *buf, uint32_t size, uint32_t count);
+    bool     RingBuf_Put(ringbuf_t *rb, const void *rec);
+    bool     RingBuf_Get(ringbuf_t *rb, void *rec);
+    void    *RingBuf_Peek(ringbuf_t *rb);
+    void    *RingBuf_PeekAt(ringbuf_t *rb, uint32_t index);
+    void     RingBuf_Drop(ringbuf_t *rb);
+    void     RingBuf_Skip(ringbuf_t *rb, uint32_t n);
+    uint32_t RingBuf_Count(const ringbuf_t *rb);
+    uint32_t RingBuf_Free(const ringbuf_t *rb);
+    void     RingBuf_Reset(ringbuf_t *rb);
+
+#endif
+
+/* [] END OF FILE */
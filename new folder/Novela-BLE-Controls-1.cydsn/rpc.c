@@ -0,0 +1,408 @@
+/*******************************************************************************
+* File Name: rpc.c
+*
+* Version: 1.20
+*
+* Description:
+*   Cross-core calls, see rpc.h. Built for both cores: the CM0+ part
+*   runs the calls, the CM4 part makes them.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "rpc.h"
+#include <string.h>
+
+/*********************************************************************
+* Pipe configuration                                                 *
+**********************************************************************/
+#define RPC_CLIENT_CALL         (0u)    /* CM4 -> CM0+                      */
+#define RPC_CLIENT_REPLY        (1u)    /* CM0+ -> CM4                      */
+#define RPC_CLIENT_COUNT        (2u)
+
+#define RPC_INTR_MASK           ((1uL << RPC_INTR_CM0) | (1uL << RPC_INTR_CM4))
+#define RPC_EP_CONFIG(chan, intr)  ((RPC_INTR_MASK << CY_IPC_PIPE_CFG_IMASK_Pos) | \
+                                    ((uint32_t)(intr) << CY_IPC_PIPE_CFG_INTR_Pos) | (uint32_t)(chan))
+
+#if (CY_CPU_CORTEX_M0P)
+    #define RPC_EP_LOCAL        RPC_EP_CM0
+#else
+    #define RPC_EP_LOCAL        RPC_EP_CM4
+#endif
+
+static void Rpc_Isr(void);
+
+static cy_ipc_pipe_callback_ptr_t rpcCallbacks[RPC_CLIENT_COUNT];
+
+static const cy_stc_ipc_pipe_config_t rpcPipeConfig =
+{
+    .ep0ConfigData =
+    {
+        .ipcNotifierNumber    = RPC_INTR_CM0,
+        .ipcNotifierPriority  = RPC_PRIORITY_CM0,
+        .ipcNotifierMuxNumber = RPC_MUX_CM0,
+        .epAddress            = RPC_EP_CM0,
+        .epConfig             = RPC_EP_CONFIG(RPC_CHAN_CM0, RPC_INTR_CM0),
+    },
+    .ep1ConfigData =
+    {
+        .ipcNotifierNumber    = RPC_INTR_CM4,
+        .ipcNotifierPriority  = RPC_PRIORITY_CM4,
+        .ipcNotifierMuxNumber = 0u,
+        .epAddress            = RPC_EP_CM4,
+        .epConfig             = RPC_EP_CONFIG(RPC_CHAN_CM4, RPC_INTR_CM4),
+    },
+    .endpointClientsCount    = RPC_CLIENT_COUNT,
+    .endpointsCallbacksArray = rpcCallbacks,
+    .userPipeIsrHandler      = &Rpc_Isr,
+};
+
+/*******************************************************************************
+* Function: Rpc_Isr
+* Input:    void
+* Return:   void
+* Description:
+*    Pipe interrupt of this core's endpoint
+*******************************************************************************/
+static void Rpc_Isr(void)
+{
+    Cy_IPC_Pipe_ExecuteCallback(RPC_EP_LOCAL);
+}
+
+/*******************************************************************************
+* Function: Rpc_CheckSteps
+* Input:    step  - RPC_OP_STEPS list
+*           count - steps in the list
+* Return:   true if the CM0+ would run the list
+* Description:
+*    The CM4 checks a list before it calls, the CM0+ again before it runs
+*    it, so a bad one does nothing at all
+*******************************************************************************/
+bool Rpc_CheckSteps(const rpc_step_t *step, uint32_t count)
+{
+    uint32_t i;
+
+    if((step == NULL) || (count == 0u) || (count > RPC_MAX_STEPS))
+    {
+        return false;
+    }
+    for(i = 0u; i < count; i++)
+    {
+        if(step[i].reg >= (uint8_t)REGS_COUNT)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if (CY_CPU_CORTEX_M0P)
+
+/*********************************************************************
+* Module Variables                                                   *
+*   rpcPending is written by the pipe ISR, then owned by the loop.   *
+*   While steps run, rpcReply and rpcStep belong to the SysTick ISR  *
+*   until it sets rpcDone.                                           *
+**********************************************************************/
+static rpc_msg_t     rpcPending;
+static volatile bool rpcHasPending = false;
+static rpc_msg_t     rpcReply;
+static rpc_step_t    rpcStep[RPC_MAX_STEPS];
+static uint32_t      rpcStepCount = 0u;
+static uint32_t      rpcStepNext = 0u;
+static volatile bool rpcStepping = false;
+static volatile bool rpcDone = false;
+
+/*******************************************************************************
+* Function: Rpc_OnCall
+* Input:    msgPtr - the request, in CM4 SRAM
+* Return:   void
+* Description:
+*    Pipe callback. Copies the request so the CM4 gets its channel back at
+*    once; the main loop runs it.
+*******************************************************************************/
+static void Rpc_OnCall(uint32_t *msgPtr)
+{
+    if(!rpcHasPending)
+    {
+        memcpy(&rpcPending, msgPtr, sizeof(rpcPending));
+        rpcHasPending = true;
+    }
+}
+
+/*******************************************************************************
+* Function: Rpc_RunSteps
+* Input:    void
+* Return:   void
+* Description:
+*    Applies steps up to the next one with a wait, then arms the SysTick
+*    for that wait; after the last one it stops the SysTick and leaves the
+*    reply to Rpc_Process(). Steps without a wait go out back to back.
+*******************************************************************************/
+static void Rpc_RunSteps(void)
+{
+    const rpc_step_t *step;
+    regs_change_t change;
+
+    while(rpcStepNext < rpcStepCount)
+    {
+        step = &rpcStep[rpcStepNext];
+        Regs_Write((regs_id_t)step->reg, step->code);
+        Regs_GetChange((regs_id_t)step->reg, &change);
+        if(rpcStepNext == 0u)
+        {
+            rpcReply.arg[1] = change.time;
+        }
+        rpcReply.arg[2] = change.time;
+        rpcStepNext++;
+
+        if(step->delayUs != 0u)
+        {
+            /* Counts LOAD + 1 clocks from the clear */
+            Cy_SysTick_SetReload((step->delayUs * (SystemCoreClock / 1000000u)) - 1u);
+            Cy_SysTick_Clear();
+            Cy_SysTick_Enable();
+            return;
+        }
+    }
+
+    Cy_SysTick_Disable();
+    rpcReply.arg[0] = rpcStepCount;
+    rpcStepping     = false;
+    rpcDone         = true;
+}
+
+/*******************************************************************************
+* Function: Rpc_StepTick
+* Input:    void
+* Return:   void
+* Description:
+*    SysTick callback, the wait after a step is over
+*******************************************************************************/
+static void Rpc_StepTick(void)
+{
+    if(rpcStepping)
+    {
+        Rpc_RunSteps();
+    }
+}
+
+/*******************************************************************************
+* Function: Rpc_Steps
+* Input:    msg - RPC_OP_STEPS request, in rpcReply
+* Return:   true if the steps started and the reply comes from the SysTick
+* Description:
+*    Copies the list, so the CM4 buffer is only read here
+*******************************************************************************/
+static bool Rpc_Steps(rpc_msg_t *msg)
+{
+    if(!Rpc_CheckSteps((const rpc_step_t *)msg->data, msg->len))
+    {
+        msg->status = RPC_ERR_ARG;
+        return false;
+    }
+
+    memcpy(rpcStep, msg->data, msg->len * sizeof(rpc_step_t));
+    rpcStepCount = msg->len;
+    rpcStepNext  = 0u;
+    rpcStepping  = true;
+    Rpc_RunSteps();
+    return true;
+}
+
+/*******************************************************************************
+* Function: Rpc_Reply
+* Input:    void
+* Return:   void
+* Description:
+*    Sends rpcReply. Busy only until the CM4 has taken the previous reply.
+*******************************************************************************/
+static void Rpc_Reply(void)
+{
+    rpcReply.header = RPC_CLIENT_REPLY;
+    while(Cy_IPC_Pipe_SendMessage(RPC_EP_CM4, RPC_EP_CM0, &rpcReply, NULL) != CY_IPC_PIPE_SUCCESS)
+    {
+    }
+}
+
+/*******************************************************************************
+* Function: Rpc_Process
+* Input:    void
+* Return:   void
+* Description:
+*    Called from the CM0+ main loop after every wake up. Sends the reply
+*    of steps that have finished, then starts the pending call, if any;
+*    a call that does not run on the SysTick is answered at once.
+*******************************************************************************/
+void Rpc_Process(void)
+{
+    if(rpcDone)
+    {
+        rpcDone = false;
+        Rpc_Reply();
+    }
+
+    if(!rpcHasPending || rpcStepping)
+    {
+        return;
+    }
+
+    rpcReply = rpcPending;
+    rpcHasPending = false;
+    rpcReply.status = RPC_OK;
+
+    switch(rpcReply.op)
+    {
+        case RPC_OP_PING:
+            break;
+
+        case RPC_OP_STEPS:
+            if(Rpc_Steps(&rpcReply))
+            {
+                return;
+            }
+            break;
+
+        default:
+            rpcReply.status = RPC_ERR_OP;
+            break;
+    }
+
+    Rpc_Reply();
+}
+
+/*******************************************************************************
+* Function: Rpc_HasPending
+* Input:    void
+* Return:   true if a call or a reply waits for Rpc_Process()
+* Description:
+*    For the sleep decision of the CM0+ loop. Check it with interrupts off
+*    and sleep in the same critical section, or a call that lands in
+*    between waits for the next unrelated wake up.
+*******************************************************************************/
+bool Rpc_HasPending(void)
+{
+    return (rpcHasPending && !rpcStepping) || rpcDone;
+}
+
+/*******************************************************************************
+* Function: Rpc_IsStepping
+* Input:    void
+* Return:   true while RPC_OP_STEPS waits on the SysTick
+* Description:
+*    The SysTick stops in Deep Sleep, so the loop only sleeps meanwhile
+*******************************************************************************/
+bool Rpc_IsStepping(void)
+{
+    return rpcStepping;
+}
+
+/*******************************************************************************
+* Function: Rpc_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Opens the CM0+ endpoint and sets up the SysTick that times the steps,
+*    stopped until a call needs it. Call before Cy_SysEnableCM4().
+*******************************************************************************/
+void Rpc_Init(void)
+{
+    Cy_IPC_Pipe_Init(&rpcPipeConfig);
+    (void)Cy_IPC_Pipe_RegisterCallback(RPC_EP_CM0, &Rpc_OnCall, RPC_CLIENT_CALL);
+
+    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU, 0u);
+    Cy_SysTick_Disable();
+    (void)Cy_SysTick_SetCallback(0u, &Rpc_StepTick);
+    NVIC_SetPriority(SysTick_IRQn, RPC_STEP_PRIORITY);
+}
+
+#else
+
+/*********************************************************************
+* Module Variables                                                   *
+*   rpcRequest stays put until the CM0+ has copied it                *
+**********************************************************************/
+static rpc_msg_t     rpcRequest;
+static rpc_done_t    rpcDone = NULL;
+static void         *rpcContext = NULL;
+static volatile bool rpcBusy = false;
+
+/*******************************************************************************
+* Function: Rpc_OnReply
+* Input:    msgPtr - the reply, in CM0+ SRAM
+* Return:   void
+* Description:
+*    Pipe callback. The done callback may start the next call.
+*******************************************************************************/
+static void Rpc_OnReply(uint32_t *msgPtr)
+{
+    rpc_msg_t  reply;
+    rpc_done_t done = rpcDone;
+    void      *context = rpcContext;
+
+    memcpy(&reply, msgPtr, sizeof(reply));
+    rpcBusy = false;
+
+    if(done != NULL)
+    {
+        done(&reply, context);
+    }
+}
+
+/*******************************************************************************
+* Function: Rpc_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Opens the CM4 endpoint. Call once before the scheduler.
+*******************************************************************************/
+void Rpc_Init(void)
+{
+    Cy_IPC_Pipe_Init(&rpcPipeConfig);
+    (void)Cy_IPC_Pipe_RegisterCallback(RPC_EP_CM4, &Rpc_OnReply, RPC_CLIENT_REPLY);
+}
+
+/*******************************************************************************
+* Function: Rpc_Call
+* Input:    request - op, arguments and data; copied, data is not
+*           done    - called from the pipe ISR with the reply, may be NULL
+*           context - passed to done
+* Return:   false if a call is still in flight, nothing was sent
+* Description:
+*    Never blocks. Safe from tasks and from the done callback.
+*******************************************************************************/
+bool Rpc_Call(const rpc_msg_t *request, rpc_done_t done, void *context)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    if(rpcBusy)
+    {
+        Cy_SysLib_ExitCriticalSection(interruptState);
+        return false;
+    }
+    rpcBusy = true;
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    rpcRequest        = *request;
+    rpcRequest.header = RPC_CLIENT_CALL;
+    rpcRequest.status = RPC_OK;
+    rpcDone           = done;
+    rpcContext        = context;
+
+    if(Cy_IPC_Pipe_SendMessage(RPC_EP_CM0, RPC_EP_CM4, &rpcRequest, NULL) != CY_IPC_PIPE_SUCCESS)
+    {
+        rpcBusy = false;
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,133 @@
+/*******************************************************************************
+* File Name: rpc.h
+*
+* Version: 1.20
+*
+* Description:
+*   Cross-core calls. The CM4 asks the CM0+ to run a short, strictly timed
+*   job and is called back when it is done. The CM0+ never runs the BLE
+*   host, so the only thing that can delay a job there is the controller
+*   ISR.
+*
+*   The calls travel on a pipe of their own, next to the system pipe that
+*   the BLE stack uses:
+*       endpoint 2   CM0+, IPC channel 10, IPC interrupt 10, NVIC mux 4
+*       endpoint 3   CM4,  IPC channel 11, IPC interrupt 11
+*
+*   One call is in flight at a time:
+*     1. Rpc_Call() copies the request and sends it.
+*     2. The CM0+ pipe ISR copies it again and frees the channel.
+*     3. Rpc_Process() runs it from the CM0+ main loop.
+*     4. The reply comes back on the same pipe.
+*     5. The done callback runs in the CM4 pipe ISR, so keep it short,
+*        e.g. give a task notification.
+*
+*   RPC_OP_STEPS drives the front end pins through regs.c from the CM0+.
+*   regs.c updates a port with a read of OUT and a write of OUT_INV, and
+*   its critical section only covers the core it runs on, so the ports
+*   have one owner at a time: the CM4 control task stops the sequencer,
+*   makes the call and blocks until the reply (control.c), and nothing
+*   else on the CM4 writes them. The CM4 does not see these changes in its
+*   own regs.c records, so the reply carries their Ts_Now() stamps instead.
+*
+*   The steps are timed by the CM0+ SysTick, not by a busy wait: the first
+*   is applied from Rpc_Process(), the rest from the SysTick ISR, and the
+*   loop only goes into Sleep, not Deep Sleep, while they run. The ISR is
+*   above the controller ISR, so a step is never late by a BLE event.
+*
+*   STEPS characteristic, write only, 1 .. RPC_MAX_STEPS times:
+*       [0]     register, regs_id_t
+*       [1]     code
+*       [2..3]  wait after the pins changed, us, little endian
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef RPC_H
+
+    #define RPC_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "regs.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define RPC_EP_CM0                  (2u)    /* pipe endpoint addresses      */
+    #define RPC_EP_CM4                  (3u)
+    #define RPC_CHAN_CM0                (10u)   /* IPC channel each one reads   */
+    #define RPC_CHAN_CM4                (11u)
+    #define RPC_INTR_CM0                (10u)   /* IPC interrupt structures     */
+    #define RPC_INTR_CM4                (11u)
+    #define RPC_MUX_CM0                 (4u)    /* Deep Sleep capable NVIC mux  */
+    #define RPC_PRIORITY_CM0            (3u)
+    #define RPC_PRIORITY_CM4            (7u)    /* done callback may use FromISR*/
+
+    #define RPC_MAX_ARGS                (4u)
+    #define RPC_MAX_STEPS               (16u)
+    #define RPC_STEP_SIZE               (4u)    /* one step on the STEPS char   */
+    #define RPC_STEP_PRIORITY           (2u)    /* CM0+ SysTick, BLESS is 3     */
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef enum
+    {
+        RPC_OP_PING = 0u,       /* arg[0] echoed, for a round trip check    */
+        RPC_OP_STEPS,           /* data = rpc_step_t[len], back to back;
+                                   reply arg[0] = steps, arg[1], arg[2] =
+                                   time of the first and last change        */
+        RPC_OP_COUNT
+    } rpc_op_t;
+
+    typedef enum
+    {
+        RPC_OK = 0u,
+        RPC_ERR_OP,             /* unknown operation                        */
+        RPC_ERR_ARG             /* bad argument, nothing was done           */
+    } rpc_status_t;
+
+    /* One step of RPC_OP_STEPS */
+    typedef struct
+    {
+        uint8_t  reg;           /* regs_id_t                                */
+        uint8_t  code;
+        uint16_t delayUs;       /* wait after the pins changed              */
+    } rpc_step_t;
+
+    typedef struct
+    {
+        uint32_t    header;     /* pipe: client, user byte, release mask    */
+        uint16_t    op;         /* rpc_op_t                                 */
+        uint16_t    status;     /* reply: rpc_status_t                      */
+        uint32_t    arg[RPC_MAX_ARGS];
+        const void *data;       /* SRAM, owned by the caller until done     */
+        uint32_t    len;
+    } rpc_msg_t;
+
+    typedef void (*rpc_done_t)(const rpc_msg_t *reply, void *context);
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void Rpc_Init(void);
+    bool Rpc_CheckSteps(const rpc_step_t *step, uint32_t count);
+#if (CY_CPU_CORTEX_M0P)
+    void Rpc_Process(void);
+    bool Rpc_HasPending(void);
+    bool Rpc_IsStepping(void);
+#else
+    bool Rpc_Call(const rpc_msg_t *request, rpc_done_t done, void *context);
+#endif
+
+#endif
+
+/* [] END OF FILE */
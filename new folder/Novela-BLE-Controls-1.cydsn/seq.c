@@ -0,0 +1,267 @@
+/*******************************************************************************
+* File Name: seq.c
+*
+* Version: 1.20
+*
+* Description:
+*   MUX scan sequencer on TCPWM0 counter 2.
+*   The counter runs continuously at 1 MHz with period = dwell - 1, so the
+*   dwell is set by hardware and ISR latency never accumulates. The terminal
+*   count ISR only moves to the next channel through Regs_Write(), which is
+*   constant time. The ISR makes no RTOS calls and runs above
+*   configMAX_SYSCALL_INTERRUPT_PRIORITY so the kernel never delays it.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "seq.h"
+#include "regs.h"
+
+/*********************************************************************
+* Counter configuration                                              *
+**********************************************************************/
+static const cy_stc_tcpwm_counter_config_t seqCounterConfig =
+{
+    .period             = 0xFFFFFFFFUL,     /* set per sequence */
+    .clockPrescaler     = CY_TCPWM_COUNTER_PRESCALER_DIVBY_1,
+    .runMode            = CY_TCPWM_COUNTER_CONTINUOUS,
+    .countDirection     = CY_TCPWM_COUNTER_COUNT_UP,
+    .compareOrCapture   = CY_TCPWM_COUNTER_MODE_COMPARE,
+    .compare0           = 0UL,
+    .compare1           = 0UL,
+    .enableCompareSwap  = false,
+    .interruptSources   = CY_TCPWM_INT_ON_TC,
+    .captureInputMode   = CY_TCPWM_INPUT_RISINGEDGE,
+    .captureInput       = CY_TCPWM_INPUT_0,
+    .reloadInputMode    = CY_TCPWM_INPUT_RISINGEDGE,
+    .reloadInput        = CY_TCPWM_INPUT_0,
+    .startInputMode     = CY_TCPWM_INPUT_RISINGEDGE,
+    .startInput         = CY_TCPWM_INPUT_0,
+    .stopInputMode      = CY_TCPWM_INPUT_RISINGEDGE,
+    .stopInput          = CY_TCPWM_INPUT_0,
+    .countInputMode     = CY_TCPWM_INPUT_LEVEL,
+    .countInput         = CY_TCPWM_INPUT_1,
+};
+
+static const cy_stc_sysint_t seqIntrConfig =
+{
+    .intrSrc      = SEQ_TCPWM_IRQN,
+    .intrPriority = SEQ_INTR_PRIORITY,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+*   Written by the BLE task only while the counter is stopped        *
+**********************************************************************/
+static uint8_t           seqList[SEQ_MAX_CHANNELS];
+static uint32_t          seqCount = 0u;
+static uint32_t          seqSweeps = 0u;        /* 0 = run until stopped */
+static uint32_t          seqIdle = 0u;
+static volatile uint32_t seqIndex = 0u;
+static volatile uint32_t seqSweep = 0u;
+static volatile uint32_t seqChannel = 0u;
+static volatile bool     seqRunning = false;
+
+/*******************************************************************************
+* Function: Seq_Halt
+* Input:    void
+* Return:   void
+* Description:
+*    Stops the counter and drops a terminal count that is already pending
+*******************************************************************************/
+static void Seq_Halt(void)
+{
+    Cy_TCPWM_TriggerStopOrKill(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_MASK);
+    Cy_TCPWM_ClearInterrupt(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_NUM, CY_TCPWM_INT_ON_TC);
+    NVIC_ClearPendingIRQ(SEQ_TCPWM_IRQN);
+    seqRunning = false;
+}
+
+/*******************************************************************************
+* Function: Seq_Isr
+* Input:    void
+* Return:   void
+* Description:
+*    Terminal count: the dwell of the current channel is over
+*******************************************************************************/
+static void Seq_Isr(void)
+{
+    uint32_t index = seqIndex + 1u;
+
+    Cy_TCPWM_ClearInterrupt(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_NUM, CY_TCPWM_INT_ON_TC);
+
+    if(index >= seqCount)
+    {
+        index = 0u;
+        seqSweep++;
+        if((seqSweeps != 0u) && (seqSweep >= seqSweeps))
+        {
+            Seq_Halt();
+            seqChannel = seqIdle;
+            Regs_Write(REGS_MUX, seqIdle);
+            return;
+        }
+    }
+
+    seqIndex   = index;
+    seqChannel = seqList[index];
+    Regs_Write(REGS_MUX, seqChannel);
+}
+
+/*******************************************************************************
+* Function: Seq_Init
+* Input:    void
+* Return:   void
+* Description:
+*    This function sets up the counter clock, the counter and its interrupt.
+*    The counter stays stopped until a SEQ write. Call before the scheduler.
+*******************************************************************************/
+void Seq_Init(void)
+{
+    (void)Cy_SysClk_PeriphAssignDivider(SEQ_TCPWM_PCLK, CY_SYSCLK_DIV_16_BIT, SEQ_CLOCK_DIV_NUM);
+    (void)Cy_SysClk_PeriphSetDivider(CY_SYSCLK_DIV_16_BIT, SEQ_CLOCK_DIV_NUM, SEQ_CLOCK_DIVIDER);
+    (void)Cy_SysClk_PeriphEnableDivider(CY_SYSCLK_DIV_16_BIT, SEQ_CLOCK_DIV_NUM);
+
+    (void)Cy_TCPWM_Counter_Init(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_NUM, &seqCounterConfig);
+    Cy_TCPWM_Enable_Multiple(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_MASK);
+
+    (void)Cy_SysInt_Init(&seqIntrConfig, &Seq_Isr);
+    NVIC_EnableIRQ(SEQ_TCPWM_IRQN);
+}
+
+/*******************************************************************************
+* Function: Seq_Stop
+* Input:    void
+* Return:   void
+* Description:
+*    Stops a running sweep and leaves the MUX pins where they are. Called
+*    before anything else writes the MUX register.
+*******************************************************************************/
+void Seq_Stop(void)
+{
+    Seq_Halt();
+}
+
+/*******************************************************************************
+* Function: Seq_IsRunning
+* Input:    void
+* Return:   true while a sweep is in progress
+*******************************************************************************/
+bool Seq_IsRunning(void)
+{
+    return seqRunning;
+}
+
+/*******************************************************************************
+* Function: Seq_GetChannel
+* Input:    void
+* Return:   MUX channel currently on the pins while a sweep runs
+* Description:
+*    Lets sample producers tag their samples. Safe to call from an ISR.
+*******************************************************************************/
+uint32_t Seq_GetChannel(void)
+{
+    return seqChannel;
+}
+
+/*******************************************************************************
+* Function: Seq_Check
+* Input:    value - the value written to the SEQ characteristic
+* Return:   GATT error to report back to the client
+* Description:
+*    Validates a SEQ write without touching the sequencer, so the BLE task
+*    can answer the client before the write is carried out elsewhere.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Seq_Check(const cy_stc_ble_gatt_value_t *value)
+{
+    const uint8_t *p = value->val;
+    uint32_t dwell;
+    uint32_t count;
+    uint32_t i;
+
+    if(value->len < SEQ_HEADER_SIZE)
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+
+    dwell = (uint32_t)p[0] | ((uint32_t)p[1] << 8u) | ((uint32_t)p[2] << 16u) | ((uint32_t)p[3] << 24u);
+    count = p[6];
+
+    if((count > SEQ_MAX_CHANNELS) || (value->len != (SEQ_HEADER_SIZE + count)))
+    {
+        return CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+    if((count != 0u) && (dwell < SEQ_MIN_DWELL_US))
+    {
+        return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+    }
+    for(i = 0u; i < count; i++)
+    {
+        if(p[SEQ_HEADER_SIZE + i] > REGS_MUX_MAX_CODE)
+        {
+            return CY_BLE_GATT_ERR_OUT_OF_RANGE;
+        }
+    }
+
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/*******************************************************************************
+* Function: Seq_Write
+* Input:    value       - the value written to the SEQ characteristic
+*           idleChannel - MUX code to return to when the sweep ends
+* Return:   GATT error to report back to the client
+* Description:
+*    Validates and loads a new sweep and starts it on the first channel.
+*    A sweep that is already running is replaced.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Seq_Write(const cy_stc_ble_gatt_value_t *value, uint32_t idleChannel)
+{
+    const uint8_t *p = value->val;
+    cy_en_ble_gatt_err_code_t gattErr;
+    uint32_t dwell;
+    uint32_t count;
+    uint32_t i;
+
+    gattErr = Seq_Check(value);
+    if(gattErr != CY_BLE_GATT_ERR_NONE)
+    {
+        return gattErr;
+    }
+
+    dwell = (uint32_t)p[0] | ((uint32_t)p[1] << 8u) | ((uint32_t)p[2] << 16u) | ((uint32_t)p[3] << 24u);
+    count = p[6];
+
+    Seq_Halt();
+    if(count == 0u)
+    {
+        return CY_BLE_GATT_ERR_NONE;
+    }
+
+    for(i = 0u; i < count; i++)
+    {
+        seqList[i] = p[SEQ_HEADER_SIZE + i];
+    }
+    seqCount   = count;
+    seqSweeps  = (uint32_t)p[4] | ((uint32_t)p[5] << 8u);
+    seqIdle    = idleChannel;
+    seqIndex   = 0u;
+    seqSweep   = 0u;
+    seqChannel = seqList[0];
+    seqRunning = true;
+
+    Regs_Write(REGS_MUX, seqChannel);
+    Cy_TCPWM_Counter_SetPeriod(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_NUM, dwell - 1u);
+    Cy_TCPWM_Counter_SetCounter(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_NUM, 0u);
+    Cy_TCPWM_TriggerStart(SEQ_TCPWM_HW, SEQ_TCPWM_CNT_MASK);
+
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+/* [] END OF FILE */
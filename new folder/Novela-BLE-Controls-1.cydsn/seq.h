@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: seq.h
+*
+* Version: 1.20
+*
+* Description:
+*   MUX scan sequencer. One write to the SEQ characteristic loads a channel
+*   list, a dwell time and a repeat count; a TCPWM counter then steps MUX0..3
+*   through the list from its terminal count interrupt, independent of the
+*   radio and of the RTOS.
+*
+*   SEQ write layout (little endian):
+*       [0..3]   dwell per channel in us (SEQ_MIN_DWELL_US and up)
+*       [4..5]   number of sweeps through the list, 0 = until stopped
+*       [6]      number of channels in the list, 0 = stop the sequencer
+*       [7..]    MUX channel codes, 0x00..0x0F
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef SEQ_H
+
+    #define SEQ_H
+
+    #include <project.h>
+    #include <stdbool.h>
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define SEQ_MAX_CHANNELS            (16u)
+    #define SEQ_HEADER_SIZE             (7u)
+    #define SEQ_MIN_DWELL_US            (10u)   /* keeps the ISR below ~10% CPU */
+
+    /* The Timer component in TopDesign is not placed, so the sequencer runs
+       TCPWM0 counter 2 directly from its own 1 MHz peripheral clock */
+    #define SEQ_TCPWM_HW                TCPWM0
+    #define SEQ_TCPWM_CNT_NUM           (2u)
+    #define SEQ_TCPWM_CNT_MASK          (1UL << SEQ_TCPWM_CNT_NUM)
+    #define SEQ_TCPWM_PCLK              PCLK_TCPWM0_CLOCKS2
+    #define SEQ_TCPWM_IRQN              tcpwm_0_interrupts_2_IRQn
+    #define SEQ_CLOCK_DIV_NUM           (1u)    /* 16 bit divider, #0 is PWM_BLINK */
+    #define SEQ_CLOCK_DIVIDER           (49u)   /* clk_peri 50 MHz / 50 = 1 MHz    */
+    #define SEQ_INTR_PRIORITY           (0u)    /* above the RTOS, never delayed   */
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void     Seq_Init(void);
+    void     Seq_Stop(void);
+    bool     Seq_IsRunning(void);
+    uint32_t Seq_GetChannel(void);
+    cy_en_ble_gatt_err_code_t Seq_Check(const cy_stc_ble_gatt_value_t *value);
+    cy_en_ble_gatt_err_code_t Seq_Write(const cy_stc_ble_gatt_value_t *value, uint32_t idleChannel);
+
+#endif
+
+/* [] END OF FILE */
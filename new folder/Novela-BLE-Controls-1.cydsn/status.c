@@ -0,0 +1,150 @@
+/*******************************************************************************
+* File Name: status.c
+*
+* Version: 1.20
+*
+* Description:
+*   STATUS notifications for Write Commands. Everything runs in the BLE task:
+*   Status_Add() from the event handler, Status_Process() after
+*   Cy_BLE_ProcessEvents(), so all commands that arrived in the same
+*   connection event are reported together.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "status.h"
+#include "conn.h"
+#include <string.h>
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+static cy_stc_ble_conn_handle_t statusConn;
+static uint16_t                 statusCommands = 0u;
+static uint32_t                 statusCount = 0u;
+static uint8_t                  statusResults[STATUS_MAX_RESULTS * STATUS_RESULT_SIZE];
+static uint8_t                  statusFrame[STATUS_HEADER_SIZE + (STATUS_MAX_RESULTS * STATUS_RESULT_SIZE)];
+
+/*******************************************************************************
+* Function: Status_IsEnabled
+* Input:    connHandle - connection to check
+* Return:   true when the client has STATUS notifications enabled
+*******************************************************************************/
+static bool Status_IsEnabled(cy_stc_ble_conn_handle_t *connHandle)
+{
+    return Cy_BLE_GATTS_IsNotificationEnabled(connHandle, CY_BLE_LED_STATUS_CHAR_HANDLE);
+}
+
+/*******************************************************************************
+* Function: Status_Add
+* Input:    connHandle - connection the Write Command came in on
+*           attrHandle - attribute that was written
+*           gattErr    - result of the write
+* Return:   void
+* Description:
+*    Queues the result of one Write Command. Results are only kept while the
+*    client listens; when the batch is full only the command counter moves.
+*******************************************************************************/
+void Status_Add(cy_stc_ble_conn_handle_t connHandle, cy_ble_gatt_db_attr_handle_t attrHandle,
+                cy_en_ble_gatt_err_code_t gattErr)
+{
+    uint8_t *p;
+
+    statusConn = connHandle;
+    statusCommands++;
+
+    if(!Status_IsEnabled(&statusConn) || (statusCount >= STATUS_MAX_RESULTS))
+    {
+        return;
+    }
+
+    p = &statusResults[statusCount * STATUS_RESULT_SIZE];
+    p[0] = (uint8_t)attrHandle;
+    p[1] = (uint8_t)(attrHandle >> 8u);
+    p[2] = (uint8_t)gattErr;
+    statusCount++;
+}
+
+/*******************************************************************************
+* Function: Status_Stop
+* Input:    void
+* Return:   void
+* Description:
+*    Called on CY_BLE_EVT_GATT_DISCONNECT_IND
+*******************************************************************************/
+void Status_Stop(void)
+{
+    statusCount    = 0u;
+    statusCommands = 0u;
+}
+
+/*******************************************************************************
+* Function: Status_WriteCCCD
+* Input:    writeReqParameter - the CY_BLE_EVT_GATTS_WRITE_REQ parameter
+* Return:   GATT error to report back to the client
+* Description:
+*    Stores the STATUS CCCD written by the client
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Status_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter)
+{
+    cy_stc_ble_gatts_db_attr_val_info_t dbAttrValInfo =
+    {
+        .handleValuePair = writeReqParameter->handleValPair,
+        .connHandle      = writeReqParameter->connHandle,
+        .flags           = CY_BLE_GATT_DB_PEER_INITIATED,
+        .offset          = 0u
+    };
+
+    statusCount = 0u;
+    return Cy_BLE_GATTS_WriteAttributeValueCCCD(&dbAttrValInfo);
+}
+
+/*******************************************************************************
+* Function: Status_Process
+* Input:    void
+* Return:   void
+* Description:
+*    Sends the queued results, as many per notification as the negotiated
+*    payload allows. Results the stack cannot take yet stay queued for the
+*    next pass.
+*******************************************************************************/
+void Status_Process(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    uint32_t n;
+
+    while((statusCount != 0u) && Status_IsEnabled(&statusConn) &&
+          (Cy_BLE_GATT_GetBusyStatus(statusConn.attId) == CY_BLE_STACK_STATE_FREE))
+    {
+        n = (Conn_GetPayload(statusConn.attId) - STATUS_HEADER_SIZE) / STATUS_RESULT_SIZE;
+        if(n > statusCount)
+        {
+            n = statusCount;
+        }
+
+        statusFrame[0] = (uint8_t)statusCommands;
+        statusFrame[1] = (uint8_t)(statusCommands >> 8u);
+        statusFrame[2] = (uint8_t)n;
+        memcpy(&statusFrame[STATUS_HEADER_SIZE], statusResults, n * STATUS_RESULT_SIZE);
+
+        handleValuePair.attrHandle = CY_BLE_LED_STATUS_CHAR_HANDLE;
+        handleValuePair.value.val  = statusFrame;
+        handleValuePair.value.len  = (uint16_t)(STATUS_HEADER_SIZE + (n * STATUS_RESULT_SIZE));
+
+        if(Cy_BLE_GATTS_SendNotification(&statusConn, &handleValuePair) != CY_BLE_SUCCESS)
+        {
+            break;
+        }
+
+        statusCount -= n;
+        memmove(statusResults, &statusResults[n * STATUS_RESULT_SIZE], statusCount * STATUS_RESULT_SIZE);
+    }
+}
+
+/* [] END OF FILE */
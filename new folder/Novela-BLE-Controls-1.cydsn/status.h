@@ -0,0 +1,55 @@
+/*******************************************************************************
+* File Name: status.h
+*
+* Version: 1.20
+*
+* Description:
+*   Batched results of Write Commands (write without response) on the LED
+*   service control characteristics. Commands are applied as they arrive;
+*   their results are collected and go out as one STATUS notification after
+*   the BLE task has processed all pending events.
+*
+*   Notification layout (little endian):
+*       [0..1]   Write Commands received so far, including those whose
+*                result did not fit (lets the client spot gaps)
+*       [2]      number of results in the notification
+*       then per result:
+*       [0..1]   attribute handle that was written
+*       [2]      GATT error code, 0 on success
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef STATUS_H
+
+    #define STATUS_H
+
+    #include <project.h>
+    #include <stdbool.h>
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define STATUS_MAX_RESULTS          (32u)
+    #define STATUS_HEADER_SIZE          (3u)
+    #define STATUS_RESULT_SIZE          (3u)
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void Status_Add(cy_stc_ble_conn_handle_t connHandle, cy_ble_gatt_db_attr_handle_t attrHandle,
+                    cy_en_ble_gatt_err_code_t gattErr);
+    void Status_Stop(void);
+    void Status_Process(void);
+    cy_en_ble_gatt_err_code_t Status_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter);
+
+#endif
+
+/* [] END OF FILE */
@@ -16,6 +16,10 @@
 
 #include "stdio_user.h"
 
+#if (CY_CPU_CORTEX_M4)
+#include "log.h"
+#endif /* CY_CPU_CORTEX_M4 */
+
 #if defined (IO_STDOUT_ENABLE) && defined (IO_STDOUT_UART)
 /*******************************************************************************
 * Function Name: STDIO_PutChar
@@ -31,12 +35,40 @@
 *******************************************************************************/
 void STDIO_PutChar(uint32_t ch)
 {
+#if (CY_CPU_CORTEX_M4)
+    char c = (char)ch;
+
+    /* Non-blocking: queued for the UART_1 TX interrupt (log.c) */
+    (void)Log_Write(&c, 1u);
+#else
     /* Place the call to your function here. */
     while(0U == Cy_SCB_UART_Put(IO_STDOUT_UART, ch))
     {
         /* Wait until FIFO is full */
     }
+#endif /* CY_CPU_CORTEX_M4 */
+}
+
+#if (CY_CPU_CORTEX_M4) && defined(__GNUC__) && !defined(__ARMCC_VERSION) && (STDOUT_CR_LF == 0)
+/*******************************************************************************
+* Function Name: _write
+********************************************************************************
+*
+* Replaces the weak character by character _write() of retarget.c on CM4, so
+* one printf() is queued with a single copy into the log ring.
+*
+*******************************************************************************/
+int _write(int fd, const char *ptr, int len)
+{
+    (void)fd;
+    if((ptr == NULL) || (len <= 0))
+    {
+        return 0;
+    }
+    (void)Log_Write(ptr, (uint32_t)len);
+    return len;
 }
+#endif /* CY_CPU_CORTEX_M4 && __GNUC__ */
 #endif /* IO_STDOUT_ENABLE && IO_STDOUT_UART */
 
 #if defined (IO_STDIN_ENABLE) && defined (IO_STDIN_UART)
@@ -0,0 +1,664 @@
+/*******************************************************************************
+* File Name: stream.c
+*
+* Version: 1.20
+*
+* Description:
+*   Batched sample notifications on the STREAM characteristic.
+*   Stream_Put() is the only producer entry point and may be called from an
+*   ISR. Everything else runs in the BLE task, which owns the stack.
+*   Samples from the CM0+ arrive in streamShared, and samples from the I2C
+*   ADC in the acq.c ring; both are put into the ring from the BLE task, so
+*   with STREAM_TEST_PATTERN on there is still one producer context.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "stream.h"
+#include "ringbuf.h"
+#include "conn.h"
+#include "acq.h"
+#include "ts.h"
+#include "rice.h"
+#include "dsp.h"
+#include "feat.h"
+#include "log.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+static stream_sample_t          streamStorage[STREAM_RING_DEPTH];
+static ringbuf_t                streamRing;
+static volatile uint32_t        streamDropped = 0u;    /* producer owned */
+
+/* For producers on the CM0+, none so far; drained into streamRing by the
+   BLE task */
+static stream_sample_t          streamSharedStorage[STREAM_SHARED_DEPTH];
+static ipcring_t                streamShared;
+
+static cy_stc_ble_conn_handle_t streamConn;
+static bool                     streamConnected = false;
+static uint16_t                 streamSeq = 0u;
+static TickType_t               streamLastSend = 0u;
+static bool                     streamFeatures = false; /* feature mode last pass */
+
+/* A frame that the stack refused is kept here and retried first */
+static uint8_t                  streamFrame[STREAM_MAX_PAYLOAD];
+static uint16_t                 streamFrameLen = 0u;
+
+/* Ring count and payload of the last build that came out empty; the same
+   samples in the same payload come out empty again until a flush */
+static uint32_t                 streamEmptyCount = 0u;
+static uint32_t                 streamEmptyPayload = 0u;
+
+#if (STREAM_COMPRESS != 0u)
+/* Rice parameters for the next frame, from the residuals of the last */
+static uint32_t                 streamKTime = 2u;
+static uint32_t                 streamKValue = 4u;
+#endif
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t samples;
+    uint32_t bytes;                 /* frame bytes, headers included */
+    uint32_t cycles;                /* building the frames sent      */
+    uint32_t empty;                 /* builds with nothing to send   */
+    uint32_t emptyCycles;
+} stream_stats_t;
+
+static stream_stats_t           streamStats;
+
+#if (STREAM_TEST_PATTERN != 0u)
+static TickType_t               streamTestTick = 0u;
+static uint32_t                 streamTestIndex = 0u;
+#endif
+
+/*******************************************************************************
+* Function: Stream_Put16 / Stream_Put32
+* Description:
+*    Little endian field writers for the frame header and samples
+*******************************************************************************/
+static void Stream_Put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8u);
+}
+
+static void Stream_Put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8u);
+    p[2] = (uint8_t)(v >> 16u);
+    p[3] = (uint8_t)(v >> 24u);
+}
+
+#if (STREAM_TEST_PATTERN != 0u)
+/*******************************************************************************
+* Function: Stream_TestPattern
+* Input:    void
+* Return:   void
+* Description:
+*    Feeds a ramp at STREAM_TEST_RATE_HZ, cycling through all MUX channels.
+*    The timestamps are evenly spaced in TS_HZ ticks.
+*******************************************************************************/
+static void Stream_TestPattern(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t   n = ((uint32_t)(now - streamTestTick) * STREAM_TEST_RATE_HZ) / configTICK_RATE_HZ;
+    stream_sample_t s;
+
+    if(n == 0u)
+    {
+        return;
+    }
+    streamTestTick = now;
+
+    while(n-- != 0u)
+    {
+        s.time     = streamTestIndex * (TS_HZ / STREAM_TEST_RATE_HZ);
+        s.value    = (uint16_t)streamTestIndex;
+        s.channel  = (uint8_t)(streamTestIndex & 0x0Fu);
+        s.reserved = 0u;
+        streamTestIndex++;
+        (void)Stream_Put(&s);
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function: Stream_Deliver
+* Input:    s        - sample from the CM0+ or the ADC
+*           features - feature mode is on (feat.h)
+* Return:   void
+* Description:
+*    Runs a sample through the filter and decimation stage (dsp.h) and
+*    hands what is kept to the ring, or to feature mode instead
+*******************************************************************************/
+static void Stream_Deliver(stream_sample_t *s, bool features)
+{
+    if(!Dsp_Filter(s))
+    {
+        return;
+    }
+    if(features)
+    {
+        Feat_Put(s);
+    }
+    else
+    {
+        (void)Stream_Put(s);
+    }
+}
+
+/*******************************************************************************
+* Function: Stream_Import
+* Input:    features - feature mode is on
+* Return:   void
+* Description:
+*    Moves the CM0+ and ADC samples into the ring as far as there is room;
+*    the rest waits in their rings, which count their own drops. Feature
+*    mode takes everything, the ring does not fill there.
+*******************************************************************************/
+static void Stream_Import(bool features)
+{
+    stream_sample_t s;
+
+    while((features || (RingBuf_Free(&streamRing) != 0u)) && IpcRing_Get(&streamShared, &s))
+    {
+        Stream_Deliver(&s, features);
+    }
+    streamDropped += IpcRing_TakeDropped(&streamShared);
+
+    while((features || (RingBuf_Free(&streamRing) != 0u)) && Acq_Get(&s))
+    {
+        Stream_Deliver(&s, features);
+    }
+    streamDropped += Acq_TakeDropped();
+}
+
+/*******************************************************************************
+* Function: Stream_Init
+* Input:    void
+* Return:   void
+* Description:
+*    This function sets up the sample rings. Call once before the scheduler,
+*    then offer Stream_GetSharedRing() to the CM0+.
+*******************************************************************************/
+void Stream_Init(void)
+{
+    RingBuf_Init(&streamRing, streamStorage, sizeof(stream_sample_t), STREAM_RING_DEPTH);
+    IpcRing_Init(&streamShared, streamSharedStorage, sizeof(stream_sample_t), STREAM_SHARED_DEPTH,
+                 IPCRING_SEMA_STREAM, IPCRING_INTR_CM4);
+    streamDropped = 0u;
+}
+
+/*******************************************************************************
+* Function: Stream_Put
+* Input:    sample - sample to queue
+* Return:   true if queued, false if the ring was full and the sample dropped
+* Description:
+*    Producer entry point, never blocks. There must be only one producer.
+*******************************************************************************/
+bool Stream_Put(const stream_sample_t *sample)
+{
+    if(!RingBuf_Put(&streamRing, sample))
+    {
+        streamDropped++;
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function: Stream_Start
+* Input:    connHandle - connection the notifications go to
+* Return:   void
+* Description:
+*    Called on CY_BLE_EVT_GATT_CONNECT_IND. Samples queued while nobody was
+*    listening are stale, so the ring starts empty.
+*******************************************************************************/
+void Stream_Start(cy_stc_ble_conn_handle_t connHandle)
+{
+    streamConn       = connHandle;
+    streamConnected  = true;
+    streamSeq        = 0u;
+    streamFrameLen   = 0u;
+    streamEmptyCount = 0u;
+    RingBuf_Reset(&streamRing);
+    IpcRing_Reset(&streamShared);
+}
+
+/*******************************************************************************
+* Function: Stream_Stop
+* Input:    void
+* Return:   void
+* Description:
+*    Called on CY_BLE_EVT_GATT_DISCONNECT_IND
+*******************************************************************************/
+void Stream_Stop(void)
+{
+    streamConnected  = false;
+    streamFrameLen   = 0u;
+    streamEmptyCount = 0u;
+    RingBuf_Reset(&streamRing);
+    IpcRing_Reset(&streamShared);
+}
+
+/*******************************************************************************
+* Function: Stream_IsActive
+* Input:    void
+* Return:   true when a client is connected and has notifications enabled
+*******************************************************************************/
+bool Stream_IsActive(void)
+{
+    return streamConnected &&
+           Cy_BLE_GATTS_IsNotificationEnabled(&streamConn, CY_BLE_LED_STREAM_CHAR_HANDLE);
+}
+
+/*******************************************************************************
+* Function: Stream_GetDropped
+* Input:    void
+* Return:   number of samples lost to a full ring since power up
+*******************************************************************************/
+uint32_t Stream_GetDropped(void)
+{
+    return streamDropped;
+}
+
+/*******************************************************************************
+* Function: Stream_GetSharedRing
+* Input:    void
+* Return:   the ring the CM0+ puts its samples into
+*******************************************************************************/
+ipcring_t *Stream_GetSharedRing(void)
+{
+    return &streamShared;
+}
+
+/*******************************************************************************
+* Function: Stream_WriteCCCD
+* Input:    writeReqParameter - the CY_BLE_EVT_GATTS_WRITE_REQ parameter
+* Return:   GATT error to report back to the client
+* Description:
+*    Stores the STREAM CCCD written by the client. The stack only keeps the
+*    Service Changed CCCD by itself; custom ones are left to the application.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Stream_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter)
+{
+    cy_stc_ble_gatts_db_attr_val_info_t dbAttrValInfo =
+    {
+        .handleValuePair = writeReqParameter->handleValPair,
+        .connHandle      = writeReqParameter->connHandle,
+        .flags           = CY_BLE_GATT_DB_PEER_INITIATED,
+        .offset          = 0u
+    };
+
+    streamLastSend = xTaskGetTickCount();
+    return Cy_BLE_GATTS_WriteAttributeValueCCCD(&dbAttrValInfo);
+}
+
+/*******************************************************************************
+* Function: Stream_Report
+* Input:    void
+* Return:   void
+* Description:
+*    Logs how well the last STREAM_STATS_FRAMES frames packed: bytes on air
+*    against the 5 bytes per sample of uncompressed frames (x100), CPU
+*    cycles per sample sent, and the builds that came out empty with the
+*    cycles they cost, then starts over.
+*******************************************************************************/
+static void Stream_Report(void)
+{
+    uint32_t ratio = (streamStats.bytes != 0u) ?
+                     ((streamStats.samples * STREAM_SAMPLE_SIZE * 100u) / streamStats.bytes) : 0u;
+    uint32_t cycles = (streamStats.samples != 0u) ? (streamStats.cycles / streamStats.samples) : 0u;
+
+    LOG_INF("stream: %lu samples in %lu bytes, ratio %lu.%02lu, %lu cycles/sample, "
+            "%lu empty builds in %lu cycles\r\n",
+            (unsigned long)streamStats.samples, (unsigned long)streamStats.bytes,
+            (unsigned long)(ratio / 100u), (unsigned long)(ratio % 100u), (unsigned long)cycles,
+            (unsigned long)streamStats.empty, (unsigned long)streamStats.emptyCycles);
+
+    (void)ratio;    /* LOG_INF() is compiled out in Release */
+    (void)cycles;
+    memset(&streamStats, 0, sizeof(streamStats));
+}
+
+/*******************************************************************************
+* Function: Stream_PutHeader
+* Input:    type - STREAM_FRAME_*
+*           n    - samples in the frame
+*           base - timestamp of the first sample
+* Return:   void
+* Description:
+*    Fills the 12 header bytes both frame types share
+*******************************************************************************/
+static void Stream_PutHeader(uint8_t type, uint32_t n, uint32_t base)
+{
+    streamFrame[0] = type;
+    streamFrame[1] = (uint8_t)n;
+    Stream_Put16(&streamFrame[2], streamSeq);
+    Stream_Put32(&streamFrame[4], streamDropped);
+    Stream_Put32(&streamFrame[8], base);
+    streamSeq++;
+}
+
+#if (STREAM_COMPRESS == 0u)
+/*******************************************************************************
+* Function: Stream_BuildRawFrame
+* Input:    flush   - also emit a frame that is not full
+*           payload - bytes the frame may take
+* Return:   length of the frame in streamFrame, 0 if nothing to send
+* Description:
+*    Moves samples from the ring into streamFrame until the payload is full
+*    or the next timestamp delta no longer fits in 16 bits.
+*******************************************************************************/
+static uint16_t Stream_BuildRawFrame(bool flush, uint32_t payload)
+{
+    uint32_t max = (payload - STREAM_HEADER_SIZE) / STREAM_SAMPLE_SIZE;
+    uint32_t avail = RingBuf_Count(&streamRing);
+    uint32_t base = 0u;
+    uint32_t n;
+    uint8_t *p = &streamFrame[STREAM_HEADER_SIZE];
+    stream_sample_t *s;
+
+    if((avail == 0u) || ((avail < max) && !flush))
+    {
+        return 0u;
+    }
+
+    for(n = 0u; n < max; n++)
+    {
+        s = (stream_sample_t *)RingBuf_Peek(&streamRing);
+        if(s == NULL)
+        {
+            break;
+        }
+        if(n == 0u)
+        {
+            base = s->time;
+        }
+        else if((s->time - base) > 0xFFFFu)
+        {
+            break;
+        }
+
+        Stream_Put16(&p[0], (uint16_t)(s->time - base));
+        p[2] = s->channel;
+        Stream_Put16(&p[3], s->value);
+        p += STREAM_SAMPLE_SIZE;
+        RingBuf_Drop(&streamRing);
+    }
+
+    Stream_PutHeader(STREAM_FRAME_SAMPLES, n, base);
+    return (uint16_t)(STREAM_HEADER_SIZE + (n * STREAM_SAMPLE_SIZE));
+}
+#else
+/*******************************************************************************
+* Function: Stream_BuildRiceFrame
+* Input:    flush   - also emit a frame that is not full
+*           payload - bytes the frame may take
+* Return:   length of the frame in streamFrame, 0 if nothing to send
+* Description:
+*    Codes samples from the ring into streamFrame, layout in stream.h,
+*    until the next one no longer fits. Samples are only taken off the ring
+*    once the frame is final, so a partial frame that is not flushed yet
+*    costs nothing but the coding time. The Rice parameters come from the
+*    previous frame, so the receiver needs nothing but this frame.
+*******************************************************************************/
+static uint16_t Stream_BuildRiceFrame(bool flush, uint32_t payload)
+{
+    const stream_sample_t *s;
+    rice_writer_t w;
+    uint16_t last[STREAM_CHANNELS];
+    uint32_t seen = 0u;             /* channels with a value in the frame */
+    uint32_t kTime = streamKTime;
+    uint32_t kValue = streamKValue;
+    uint32_t sumTime = 0u;
+    uint32_t sumValue = 0u;
+    uint32_t countValue = 0u;
+    uint32_t base = 0u;
+    uint32_t prevTime = 0u;
+    uint32_t prevDelta = 0u;
+    uint32_t delta = 0u;
+    uint32_t zzTime = 0u;
+    uint32_t zzValue = 0u;
+    uint32_t bits;
+    uint32_t ch;
+    uint32_t n;
+    bool full = false;
+
+    Rice_Begin(&w, &streamFrame[STREAM_RICE_HEADER_SIZE], payload - STREAM_RICE_HEADER_SIZE);
+
+    for(n = 0u; n < STREAM_RICE_MAX_SAMPLES; n++)
+    {
+        s = (const stream_sample_t *)RingBuf_PeekAt(&streamRing, n);
+        if(s == NULL)
+        {
+            break;
+        }
+        ch   = s->channel & (STREAM_CHANNELS - 1u);
+        bits = STREAM_RICE_CHANNEL_BITS;
+
+        /* Time: change of the interval to the previous sample */
+        if(n != 0u)
+        {
+            delta = s->time - prevTime;
+            if(delta > 0xFFFFu)
+            {
+                full = true;
+                break;
+            }
+            zzTime = Rice_ZigZag((int32_t)delta - (int32_t)prevDelta);
+            bits  += Rice_Bits(zzTime, kTime);
+        }
+
+        /* Value: change to the last value of the same channel */
+        if((seen & (1uL << ch)) != 0u)
+        {
+            zzValue = Rice_ZigZag((int32_t)s->value - (int32_t)last[ch]);
+            bits   += Rice_Bits(zzValue, kValue);
+        }
+        else
+        {
+            bits += 16u;
+        }
+
+        if((w.bits + bits) > w.capBits)
+        {
+            full = true;
+            break;
+        }
+
+        Rice_PutBits(&w, ch, STREAM_RICE_CHANNEL_BITS);
+        if(n == 0u)
+        {
+            base = s->time;
+        }
+        else
+        {
+            Rice_Put(&w, zzTime, kTime);
+            sumTime  += zzTime;
+            prevDelta = delta;
+        }
+        if((seen & (1uL << ch)) != 0u)
+        {
+            Rice_Put(&w, zzValue, kValue);
+            sumValue += zzValue;
+            countValue++;
+        }
+        else
+        {
+            Rice_PutBits(&w, s->value, 16u);
+            seen |= (1uL << ch);
+        }
+        last[ch] = s->value;
+        prevTime = s->time;
+    }
+
+    if((n == 0u) || (!full && !flush && (n < STREAM_RICE_MAX_SAMPLES)))
+    {
+        return 0u;
+    }
+    RingBuf_Skip(&streamRing, n);
+
+    if(n > 1u)
+    {
+        streamKTime = Rice_Parameter(sumTime, n - 1u);
+    }
+    if(countValue != 0u)
+    {
+        streamKValue = Rice_Parameter(sumValue, countValue);
+    }
+
+    Stream_PutHeader(STREAM_FRAME_RICE, n, base);
+    streamFrame[STREAM_HEADER_SIZE] = (uint8_t)(kTime | (kValue << 4u));
+    return (uint16_t)(STREAM_RICE_HEADER_SIZE + Rice_End(&w));
+}
+#endif
+
+/*******************************************************************************
+* Function: Stream_BuildFrame
+* Input:    flush - also emit a frame that is not full
+* Return:   length of the frame in streamFrame, 0 if nothing to send
+* Description:
+*    Builds the next frame for the payload that the connection negotiated
+*    and keeps the numbers for the compression report: samples and bytes
+*    sent, the CPU cycles spent building them, and apart from those the
+*    builds that sent nothing. Without a flush, a ring that has not grown
+*    since the last empty build is not coded again.
+*******************************************************************************/
+static uint16_t Stream_BuildFrame(bool flush)
+{
+    uint32_t payload = Conn_GetPayload(streamConn.attId);
+    uint32_t count = RingBuf_Count(&streamRing);
+    uint32_t start;
+    uint32_t tail = streamRing.tail;
+    uint16_t len;
+
+    if(payload > STREAM_MAX_PAYLOAD)
+    {
+        payload = STREAM_MAX_PAYLOAD;
+    }
+    if(!flush && (count == streamEmptyCount) && (payload == streamEmptyPayload))
+    {
+        return 0u;
+    }
+
+    start = DWT->CYCCNT;
+
+#if (STREAM_COMPRESS != 0u)
+    len = Stream_BuildRiceFrame(flush, payload);
+#else
+    len = Stream_BuildRawFrame(flush, payload);
+#endif
+
+    if(len == 0u)
+    {
+        streamStats.emptyCycles += DWT->CYCCNT - start;
+        streamStats.empty++;
+        streamEmptyCount   = count;
+        streamEmptyPayload = payload;
+        return 0u;
+    }
+    streamStats.cycles  += DWT->CYCCNT - start;
+    streamEmptyCount     = 0u;
+    streamStats.samples += streamRing.tail - tail;
+    streamStats.bytes   += len;
+
+    if(++streamStats.frames >= STREAM_STATS_FRAMES)
+    {
+        Stream_Report();
+    }
+    return len;
+}
+
+/*******************************************************************************
+* Function: Stream_Process
+* Input:    void
+* Return:   void
+* Description:
+*    Consumer side, called from the BLE task after Cy_BLE_ProcessEvents().
+*    Sends full frames while the stack has buffers; a partial frame goes out
+*    once it is STREAM_FLUSH_MS old so slow sources still get through. In
+*    feature mode the samples go to feat.c and nothing is sent here.
+*******************************************************************************/
+void Stream_Process(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    cy_en_ble_api_result_t apiResult;
+    TickType_t now;
+    bool features = Feat_IsActive();
+    bool flush;
+
+    /* Samples left from streaming would sit in the ring for good */
+    if(features && !streamFeatures)
+    {
+        RingBuf_Reset(&streamRing);
+        streamFrameLen   = 0u;
+        streamEmptyCount = 0u;
+    }
+    streamFeatures = features;
+
+    if(!Stream_IsActive() && !features)
+    {
+        return;
+    }
+    if(features)
+    {
+        Stream_Import(true);
+        return;
+    }
+
+#if (STREAM_TEST_PATTERN != 0u)
+    Stream_TestPattern();
+#endif
+    Stream_Import(false);
+
+    now   = xTaskGetTickCount();
+    flush = (now - streamLastSend) >= pdMS_TO_TICKS(STREAM_FLUSH_MS);
+
+    while(Cy_BLE_GATT_GetBusyStatus(streamConn.attId) == CY_BLE_STACK_STATE_FREE)
+    {
+        if(streamFrameLen == 0u)
+        {
+            streamFrameLen = Stream_BuildFrame(flush);
+            if(streamFrameLen == 0u)
+            {
+                break;
+            }
+        }
+
+        handleValuePair.attrHandle = CY_BLE_LED_STREAM_CHAR_HANDLE;
+        handleValuePair.value.val  = streamFrame;
+        handleValuePair.value.len  = streamFrameLen;
+
+        apiResult = Cy_BLE_GATTS_SendNotification(&streamConn, &handleValuePair);
+        if(apiResult != CY_BLE_SUCCESS)
+        {
+            /* Stack out of buffers: keep the frame for the next
+               CY_BLE_EVT_STACK_BUSY_STATUS, anything else is final */
+            if((apiResult != CY_BLE_ERROR_MEMORY_ALLOCATION_FAILED) &&
+               (apiResult != CY_BLE_ERROR_INVALID_OPERATION))
+            {
+                streamFrameLen = 0u;
+            }
+            break;
+        }
+
+        streamFrameLen = 0u;
+        streamLastSend = now;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: stream.h
+*
+* Version: 1.20
+*
+* Description:
+*   Sample streaming over the LED service STREAM characteristic.
+*   Producers push timestamped samples into a ring buffer and never wait on
+*   the radio; the BLE task drains the ring and packs as many samples as fit
+*   into each notification. Producers on the CM0+ use the shared ring from
+*   Stream_GetSharedRing() instead; the BLE task moves its samples over
+*   before packing, and its drops count in the frame header as well.
+*
+*   Notification layout (little endian):
+*       [0]      frame type (STREAM_FRAME_SAMPLES)
+*       [1]      number of samples in the frame
+*       [2..3]   frame sequence number
+*       [4..7]   total samples dropped because the ring was full
+*       [8..11]  timestamp of the first sample
+*       then per sample:
+*       [0..1]   timestamp delta to the first sample
+*   Timestamps are the low 32 bits of the ts.h time base (TS_HZ), the same
+*   one the TIMESTAMP characteristic reports register changes in.
+*       [2]      MUX channel
+*       [3..4]   sample value
+*
+*   With STREAM_COMPRESS on, frames are STREAM_FRAME_RICE instead. The
+*   header is the same, then:
+*       [12]     bits 0..3 Rice k of the times, bits 4..7 of the values
+*       [13..]   per sample, bit packed MSB first (rice.h), zero padded:
+*                - MUX channel, 4 bits
+*                - except for the first sample: the change of the time
+*                  interval to the previous sample, zigzag Rice coded
+*                - the first value of a channel in the frame: 16 bits;
+*                  later ones: the change to the channel's last value,
+*                  zigzag Rice coded
+*   Every frame decodes on its own, so a lost notification costs only its
+*   own samples. tools/streamdecode.py decodes both frame types.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef STREAM_H
+
+    #define STREAM_H
+
+    #include <project.h>
+    #include <stdbool.h>
+    #include "ipcring.h"
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    #define STREAM_RING_DEPTH           (512u)  /* samples, power of two           */
+    #define STREAM_SHARED_DEPTH         (256u)  /* CM0+ samples, power of two      */
+    #define STREAM_MAX_PAYLOAD          (244u)  /* STREAM attribute length         */
+    #define STREAM_HEADER_SIZE          (12u)
+    #define STREAM_SAMPLE_SIZE          (5u)
+    #define STREAM_FLUSH_MS             (10u)   /* max age of a partial frame      */
+
+    #define STREAM_FRAME_SAMPLES        (0x01u)
+    #define STREAM_FRAME_RICE           (0x02u)
+
+    /* Delta + Rice coding of the frames, per MUX channel */
+    #define STREAM_COMPRESS             (1u)
+    #define STREAM_CHANNELS             (16u)   /* MUX codes                       */
+    #define STREAM_RICE_HEADER_SIZE     (STREAM_HEADER_SIZE + 1u)
+    #define STREAM_RICE_CHANNEL_BITS    (4u)
+    #define STREAM_RICE_MAX_SAMPLES     (255u)  /* frame header count is 8 bit     */
+    #define STREAM_STATS_FRAMES         (500u)  /* frames per compression report   */
+
+    /* Synthetic ramp source for throughput testing without a front end */
+    #define STREAM_TEST_PATTERN         (0u)
+    #define STREAM_TEST_RATE_HZ         (2000u)
+
+    /***************************************
+    *           Types
+    ***************************************/
+    typedef struct
+    {
+        uint32_t time;      /* Ts_Now() when the sample was taken   */
+        uint16_t value;     /* raw sample                           */
+        uint8_t  channel;   /* MUX channel the sample was taken on  */
+        uint8_t  reserved;
+    } stream_sample_t;
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    void     Stream_Init(void);
+    bool     Stream_Put(const stream_sample_t *sample);
+    void     Stream_Start(cy_stc_ble_conn_handle_t connHandle);
+    void     Stream_Stop(void);
+    bool     Stream_IsActive(void);
+    void     Stream_Process(void);
+    uint32_t Stream_GetDropped(void);
+    ipcring_t *Stream_GetSharedRing(void);
+    cy_en_ble_gatt_err_code_t Stream_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+# File Name: logdecode.py
+#
+# Version: 1.20
+#
+# Description:
+#   Host side decoder for the UART_1 log. Plain text is passed through,
+#   LOG_PRINTF() frames (see log.h) are turned back into text with the
+#   format strings from the .log_fmt section of the CM4 ELF file.
+#
+#   Usage:
+#       stty -F /dev/ttyUSB0 115200 raw -echo
+#       tools/logdecode.py CortexM4/ARM_GCC_541/Debug/Novela-BLE-Controls-1.elf /dev/ttyUSB0
+#
+#   The input defaults to stdin, so a captured log file can be piped in.
+#   Needs only the Python 3 standard library.
+#
+# Owners:
+#   peter@novelaneuro.com
+#
+#*******************************************************************************
+# Copyright 2019, Novela Neuro.  All rights reserved.
+# You may use this file only in accordance with the license, terms, conditions,
+# disclaimers, and limitations in the end user license agreement accompanying
+# the software package with which this file was provided.
+#*******************************************************************************
+import re
+import struct
+import sys
+
+LOG_FRAME_MARK = 0xF0
+LOG_MAX_ARGS   = 8
+LOG_SECTION    = '.log_fmt'
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(\.\d+)?(hh|h|ll|l|z|j|t)?([diouxXcp%])')
+
+
+def read_formats(path):
+    """Returns {token: format string} from the .log_fmt section of an ELF file."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+
+    if elf[:4] != b'\x7fELF':
+        sys.exit('%s: not an ELF file' % path)
+    is64   = (elf[4] == 2)
+    endian = '<' if elf[5] == 1 else '>'
+
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x3A)
+        shdr = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+        shdr = endian + 'IIIIIIIIII'
+
+    sections = [struct.unpack_from(shdr, elf, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx]
+
+    for name, _, _, addr, offset, size, _, _, _, _ in sections:
+        end = elf.index(b'\0', names[4] + name)
+        if elf[names[4] + name:end].decode() != LOG_SECTION:
+            continue
+
+        formats = {}
+        data = elf[offset:offset + size]
+        pos = 0
+        while pos < len(data):
+            end = data.find(b'\0', pos)
+            if end < 0:
+                end = len(data)
+            if end > pos:
+                formats[(addr + pos) & 0xFFFF] = data[pos:end].decode('latin-1')
+            pos = end + 1
+        return formats
+
+    sys.exit('%s: no %s section, was it built with LOG_TOKENIZED?' % (path, LOG_SECTION))
+
+
+def format_c(fmt, args):
+    """printf() subset used by LOG_PRINTF(): 32 bit integer conversions only."""
+    args = list(args)
+
+    def convert(m):
+        flags, width, precision, _, conv = m.groups()
+        if conv == '%':
+            return '%'
+        value = args.pop(0) if args else 0
+        if conv in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+            conv = 'd'
+        elif conv == 'u':
+            conv = 'd'
+        elif conv == 'p':
+            flags, conv = flags + '#', 'x'
+        elif conv == 'c':
+            value = chr(value & 0xFF)
+        return ('%' + flags + width + (precision or '') + conv) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def read_varint(stream):
+    value = 0
+    shift = 0
+    while True:
+        b = stream.read(1)
+        if not b:
+            return None
+        value |= (b[0] & 0x7F) << shift
+        if b[0] < 0x80:
+            return value & 0xFFFFFFFF
+        shift += 7
+
+
+def decode(formats, stream, out):
+    while True:
+        b = stream.read(1)
+        if not b:
+            return
+        mark = b[0]
+
+        if (mark & 0xF0) != LOG_FRAME_MARK or (mark & 0x0F) > LOG_MAX_ARGS:
+            out.write(b.decode('latin-1'))
+            continue
+
+        token = stream.read(2)
+        if len(token) < 2:
+            return
+        token = token[0] | (token[1] << 8)
+
+        args = []
+        for _ in range(mark & 0x0F):
+            value = read_varint(stream)
+            if value is None:
+                return
+            args.append(value)
+
+        fmt = formats.get(token)
+        if fmt is None:
+            out.write('<unknown log token 0x%04x %s>\r\n' % (token, ' '.join('%x' % a for a in args)))
+        else:
+            out.write(format_c(fmt, args))
+        out.flush()
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit('usage: %s <cm4 elf> [log file or tty, default stdin]' % sys.argv[0])
+
+    formats = read_formats(sys.argv[1])
+    if len(sys.argv) == 3:
+        stream = open(sys.argv[2], 'rb', buffering=0)
+    else:
+        stream = sys.stdin.buffer
+
+    try:
+        decode(formats, stream, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
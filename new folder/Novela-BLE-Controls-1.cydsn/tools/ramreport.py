@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+# File Name: ramreport.py
+#
+# Version: 1.20
+#
+# Description:
+#   RAM report for the CM4 image, run after the link. Lists the RAM
+#   sections, the kernel object buffers (task stacks and control blocks,
+#   queues, semaphores, timers: see configSUPPORT_STATIC_ALLOCATION in
+#   FreeRTOSConfig.h), the heap_4 heap and the largest other variables.
+#
+#   Usage:
+#       tools/ramreport.py CortexM4/ARM_GCC_541/Debug/Novela-BLE-Controls-1.elf [count]
+#
+#   count is the number of other variables listed, 20 by default. The
+#   linker prints the region totals too (-Wl,--print-memory-usage).
+#   Needs only the Python 3 standard library.
+#
+# Owners:
+#   peter@novelaneuro.com
+#
+#*******************************************************************************
+# Copyright 2019, Novela Neuro.  All rights reserved.
+# You may use this file only in accordance with the license, terms, conditions,
+# disclaimers, and limitations in the end user license agreement accompanying
+# the software package with which this file was provided.
+#*******************************************************************************
+import re
+import struct
+import sys
+
+RAM_START = 0x08024000          # cy8c6xx7_cm4_dual.ld, region ram
+RAM_SIZE  = 0x23800
+
+SHF_ALLOC   = 0x2
+SHT_SYMTAB  = 2
+STT_OBJECT  = 1
+
+# Naming used for the static kernel object buffers
+KERNEL = re.compile(r'(TaskStack|TaskTcb|QueueStorage|QueueBuffer|Semaphore\w*Buffer|[tT]imerBuffer)$')
+HEAP   = 'ucHeap'
+
+
+def read_elf(path):
+    """Returns ([(name, addr, size)] allocated sections, [(name, addr, size)] data symbols)."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+
+    if elf[:4] != b'\x7fELF' or elf[4] != 1:
+        sys.exit('%s: not a 32 bit ELF file' % path)
+    endian = '<' if elf[5] == 1 else '>'
+
+    shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+    sections = [struct.unpack_from(endian + 'IIIIIIIIII', elf, shoff + i * shentsize) for i in range(shnum)]
+
+    def string(table, offset):
+        start = sections[table][4] + offset
+        return elf[start:elf.index(b'\0', start)].decode('latin-1')
+
+    allocated = []
+    symbols = []
+    for name, kind, flags, addr, offset, size, link, _, _, entsize in sections:
+        if flags & SHF_ALLOC:
+            allocated.append((string(shstrndx, name), addr, size))
+        if kind == SHT_SYMTAB:
+            for pos in range(offset, offset + size, entsize):
+                sym_name, value, sym_size, info, _, _ = struct.unpack_from(endian + 'IIIBBH', elf, pos)
+                if (info & 0x0F) == STT_OBJECT and sym_size:
+                    symbols.append((string(link, sym_name), value, sym_size))
+    return allocated, symbols
+
+
+def in_ram(addr):
+    return RAM_START <= addr < RAM_START + RAM_SIZE
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit('usage: %s <cm4 elf> [count]' % sys.argv[0])
+    count = int(sys.argv[2]) if len(sys.argv) == 3 else 20
+
+    allocated, symbols = read_elf(sys.argv[1])
+
+    print('RAM sections')
+    used = 0
+    for name, addr, size in sorted(allocated, key=lambda s: s[1]):
+        if in_ram(addr) and size:
+            print('  %-16s 0x%08x %7d' % (name, addr, size))
+            used += size
+    print('  %-16s %10s %7d of %d (%d%%)' % ('total', '', used, RAM_SIZE, used * 100 // RAM_SIZE))
+
+    ram = sorted((s for s in symbols if in_ram(s[1])), key=lambda s: -s[2])
+    kernel = [s for s in ram if KERNEL.search(s[0])]
+    heap = [s for s in ram if s[0] == HEAP]
+    other = [s for s in ram if s not in kernel and s not in heap]
+
+    print('\nKernel objects (static)')
+    for name, addr, size in kernel:
+        print('  %-24s 0x%08x %7d' % (name, addr, size))
+    print('  %-24s %10s %7d' % ('total', '', sum(s[2] for s in kernel)))
+    if not kernel:
+        print('  none: built with configSUPPORT_STATIC_ALLOCATION 0, they are in the heap')
+
+    print('\nHeap (heap_4)')
+    for name, addr, size in heap:
+        print('  %-24s 0x%08x %7d' % (name, addr, size))
+
+    print('\nLargest other variables')
+    for name, addr, size in other[:count]:
+        print('  %-24s 0x%08x %7d' % (name, addr, size))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+# File Name: streamdecode.py
+#
+# Version: 1.20
+#
+# Description:
+#   Host side decoder for STREAM notifications, raw (STREAM_FRAME_SAMPLES)
+#   and delta + Rice coded (STREAM_FRAME_RICE) frames, see stream.h and
+#   rice.h. Import decode_frame() from here, or run it:
+#
+#       tools/streamdecode.py decode notifications.txt
+#           one notification per line in hex, as most BLE apps log them;
+#           prints seq, time (TS_HZ ticks), channel and value per sample
+#
+#       tools/streamdecode.py bench
+#           codes synthetic signals with a copy of the firmware encoder,
+#           checks that they decode back, and prints the bytes per sample
+#           against raw frames for the smallest and largest payload. The
+#           firmware logs its own ratio and cycles per sample on UART_1.
+#
+#   Needs only the Python 3 standard library.
+#
+# Owners:
+#   peter@novelaneuro.com
+#
+#*******************************************************************************
+# Copyright 2019, Novela Neuro.  All rights reserved.
+# You may use this file only in accordance with the license, terms, conditions,
+# disclaimers, and limitations in the end user license agreement accompanying
+# the software package with which this file was provided.
+#*******************************************************************************
+import math
+import random
+import struct
+import sys
+
+STREAM_FRAME_SAMPLES     = 0x01
+STREAM_FRAME_RICE        = 0x02
+STREAM_HEADER_SIZE       = 12
+STREAM_SAMPLE_SIZE       = 5
+STREAM_RICE_HEADER_SIZE  = 13
+STREAM_RICE_CHANNEL_BITS = 4
+STREAM_RICE_MAX_SAMPLES  = 255
+STREAM_CHANNELS          = 16
+
+RICE_MAX_K    = 15
+RICE_ESCAPE   = 16
+RICE_RAW_BITS = 17
+
+TS_HZ = 10000000
+
+
+class FrameError(Exception):
+    pass
+
+
+def zigzag(v):
+    return ((v << 1) ^ (v >> 31)) & 0xFFFFFFFF
+
+
+def unzigzag(zz):
+    return (zz >> 1) ^ -(zz & 1)
+
+
+class BitReader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def bits(self, n):
+        value = 0
+        for _ in range(n):
+            byte = self.pos >> 3
+            if byte >= len(self.data):
+                raise FrameError('frame ends inside a sample')
+            value = (value << 1) | ((self.data[byte] >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return value
+
+    def rice(self, k):
+        q = 0
+        while q < RICE_ESCAPE and self.bits(1):
+            q += 1
+        if q == RICE_ESCAPE:
+            return self.bits(RICE_RAW_BITS)
+        return (q << k) | self.bits(k)
+
+
+class BitWriter:
+    def __init__(self, cap_bytes):
+        self.cap = cap_bytes * 8
+        self.value = 0
+        self.nbits = 0
+
+    def put(self, value, n):
+        assert self.nbits + n <= self.cap
+        self.value = (self.value << n) | (value & ((1 << n) - 1))
+        self.nbits += n
+
+    def rice(self, zz, k):
+        q = zz >> k
+        if q >= RICE_ESCAPE:
+            self.put((1 << RICE_ESCAPE) - 1, RICE_ESCAPE)
+            self.put(zz, RICE_RAW_BITS)
+        else:
+            self.put((1 << (q + 1)) - 2, q + 1)
+            self.put(zz, k)
+
+    def data(self):
+        pad = (-self.nbits) & 7
+        return (self.value << pad).to_bytes((self.nbits + pad) // 8, 'big')
+
+
+def rice_bits(zz, k):
+    q = zz >> k
+    return q + 1 + k if q < RICE_ESCAPE else RICE_ESCAPE + RICE_RAW_BITS
+
+
+def rice_parameter(total, count):
+    k = 0
+    while k < RICE_MAX_K and (count << (k + 1)) <= total:
+        k += 1
+    return k
+
+
+def decode_frame(frame):
+    """Returns (seq, dropped, [(time, channel, value), ...]) of one notification."""
+    if len(frame) < STREAM_HEADER_SIZE:
+        raise FrameError('short frame')
+    ftype, n, seq, dropped, base = struct.unpack_from('<BBHII', frame, 0)
+    samples = []
+
+    if ftype == STREAM_FRAME_SAMPLES:
+        if len(frame) < STREAM_HEADER_SIZE + n * STREAM_SAMPLE_SIZE:
+            raise FrameError('short frame')
+        for i in range(n):
+            dt, channel, value = struct.unpack_from('<HBH', frame, STREAM_HEADER_SIZE + i * STREAM_SAMPLE_SIZE)
+            samples.append(((base + dt) & 0xFFFFFFFF, channel, value))
+
+    elif ftype == STREAM_FRAME_RICE:
+        if len(frame) < STREAM_RICE_HEADER_SIZE:
+            raise FrameError('short frame')
+        k_time = frame[STREAM_HEADER_SIZE] & 0x0F
+        k_value = frame[STREAM_HEADER_SIZE] >> 4
+        r = BitReader(frame[STREAM_RICE_HEADER_SIZE:])
+        last = {}
+        time, delta = base, 0
+        for i in range(n):
+            channel = r.bits(STREAM_RICE_CHANNEL_BITS)
+            if i:
+                delta += unzigzag(r.rice(k_time))
+                time = (time + delta) & 0xFFFFFFFF
+            if channel in last:
+                value = (last[channel] + unzigzag(r.rice(k_value))) & 0xFFFF
+            else:
+                value = r.bits(16)
+            last[channel] = value
+            samples.append((time, channel, value))
+
+    else:
+        raise FrameError('unknown frame type 0x%02x' % ftype)
+
+    return seq, dropped, samples
+
+
+class RiceEncoder:
+    """Copy of Stream_BuildRiceFrame(), for the benchmark and for tests."""
+
+    def __init__(self):
+        self.k_time = 2
+        self.k_value = 4
+        self.seq = 0
+
+    def frame(self, samples, payload):
+        """Codes from the front of samples; returns (frame, samples used)."""
+        w = BitWriter(payload - STREAM_RICE_HEADER_SIZE)
+        k_time, k_value = self.k_time, self.k_value
+        last = {}
+        sum_time = sum_value = count_value = 0
+        base = prev_time = prev_delta = 0
+        n = 0
+        for time, channel, value in samples[:STREAM_RICE_MAX_SAMPLES]:
+            channel &= STREAM_CHANNELS - 1
+            bits = STREAM_RICE_CHANNEL_BITS
+            if n:
+                delta = (time - prev_time) & 0xFFFFFFFF
+                if delta > 0xFFFF:
+                    break
+                zz_time = zigzag(delta - prev_delta)
+                bits += rice_bits(zz_time, k_time)
+            if channel in last:
+                zz_value = zigzag(value - last[channel])
+                bits += rice_bits(zz_value, k_value)
+            else:
+                bits += 16
+            if w.nbits + bits > w.cap:
+                break
+
+            w.put(channel, STREAM_RICE_CHANNEL_BITS)
+            if n == 0:
+                base = time
+            else:
+                w.rice(zz_time, k_time)
+                sum_time += zz_time
+                prev_delta = delta
+            if channel in last:
+                w.rice(zz_value, k_value)
+                sum_value += zz_value
+                count_value += 1
+            else:
+                w.put(value, 16)
+            last[channel] = value
+            prev_time = time
+            n += 1
+
+        if n > 1:
+            self.k_time = rice_parameter(sum_time, n - 1)
+        if count_value:
+            self.k_value = rice_parameter(sum_value, count_value)
+
+        header = struct.pack('<BBHIIB', STREAM_FRAME_RICE, n, self.seq & 0xFFFF, 0, base,
+                             k_time | (k_value << 4))
+        self.seq += 1
+        return header + w.data(), n
+
+
+def raw_bytes(count, payload):
+    per_frame = (payload - STREAM_HEADER_SIZE) // STREAM_SAMPLE_SIZE
+    frames = -(-count // per_frame)
+    return frames * STREAM_HEADER_SIZE + count * STREAM_SAMPLE_SIZE
+
+
+def signals(count):
+    """Synthetic sample sets: (name, [(time, channel, value), ...])."""
+    rnd = random.Random(1)
+    period = TS_HZ // 3300          # ADC at ACQ_AVERAGE 4
+
+    def jitter():
+        return period + rnd.randint(-3, 3)
+
+    def build(value_of, channel_of):
+        out, t = [], 0
+        for i in range(count):
+            ch = channel_of(i)
+            out.append((t & 0xFFFFFFFF, ch, max(0, min(0x0FFF, int(value_of(i, ch))))))
+            t += jitter()
+        return out
+
+    yield 'quiet, one channel', build(lambda i, ch: 2048 + rnd.gauss(0, 2), lambda i: 0)
+    yield 'EEG like, one channel', build(
+        lambda i, ch: 2048 + 300 * math.sin(i / 33.0) + 80 * math.sin(i / 5.5) + rnd.gauss(0, 6),
+        lambda i: 0)
+    yield 'sweep, 8 channels', build(
+        lambda i, ch: 1024 + 200 * ch + 150 * math.sin(i / 200.0 + ch) + rnd.gauss(0, 4),
+        lambda i: i % 8)
+    yield 'white noise, full scale', build(lambda i, ch: rnd.randint(0, 0x0FFF), lambda i: 0)
+
+
+def bench():
+    count = 20000
+    for name, samples in signals(count):
+        print(name)
+        for payload in (20, 244):
+            enc = RiceEncoder()
+            rest, coded = samples, 0
+            decoded = []
+            while rest:
+                frame, n = enc.frame(rest, payload)
+                decoded += decode_frame(frame)[2]
+                coded += len(frame)
+                rest = rest[n:]
+            if [(t, c & 0x0F, v) for t, c, v in samples] != decoded:
+                sys.exit('  payload %3d: round trip FAILED' % payload)
+            raw = raw_bytes(count, payload)
+            print('  payload %3d: raw %5.2f B/sample, rice %5.2f B/sample, ratio %4.2f' %
+                  (payload, raw / count, coded / count, raw / coded))
+
+
+def decode_file(path):
+    with open(path) as f:
+        for line in f:
+            text = ''.join(c for c in line if c in '0123456789abcdefABCDEF')
+            if not text:
+                continue
+            try:
+                seq, dropped, samples = decode_frame(bytes.fromhex(text))
+            except (FrameError, ValueError) as e:
+                print('# %s: %s' % (e, line.strip()))
+                continue
+            for time, channel, value in samples:
+                print('%5d %10d %2d %5d' % (seq, time, channel, value))
+
+
+def main():
+    if len(sys.argv) == 2 and sys.argv[1] == 'bench':
+        bench()
+    elif len(sys.argv) == 3 and sys.argv[1] == 'decode':
+        decode_file(sys.argv[2])
+    else:
+        sys.exit('usage: %s bench | decode <file of hex notifications>' % sys.argv[0])
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,281 @@
+/*******************************************************************************
+* File Name: ts.c
+*
+* Version: 1.20
+*
+* Description:
+*   Timestamp service, see ts.h.
+*   The wrap ISR is the only writer of tsHigh. Ts_Process() runs in the BLE
+*   task, the only task that touches the GATT database.
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+#include "ts.h"
+#include "regs.h"
+#include "task.h"
+
+/*********************************************************************
+* Counter configuration                                              *
+**********************************************************************/
+static const cy_stc_tcpwm_counter_config_t tsCounterConfig =
+{
+    .period             = 0xFFFFFFFFUL,     /* free running */
+    .clockPrescaler     = CY_TCPWM_COUNTER_PRESCALER_DIVBY_1,
+    .runMode            = CY_TCPWM_COUNTER_CONTINUOUS,
+    .countDirection     = CY_TCPWM_COUNTER_COUNT_UP,
+    .compareOrCapture   = CY_TCPWM_COUNTER_MODE_COMPARE,
+    .compare0           = 0UL,
+    .compare1           = 0UL,
+    .enableCompareSwap  = false,
+    .interruptSources   = CY_TCPWM_INT_ON_TC,
+    .captureInputMode   = CY_TCPWM_INPUT_RISINGEDGE,
+    .captureInput       = CY_TCPWM_INPUT_0,
+    .reloadInputMode    = CY_TCPWM_INPUT_RISINGEDGE,
+    .reloadInput        = CY_TCPWM_INPUT_0,
+    .startInputMode     = CY_TCPWM_INPUT_RISINGEDGE,
+    .startInput         = CY_TCPWM_INPUT_0,
+    .stopInputMode      = CY_TCPWM_INPUT_RISINGEDGE,
+    .stopInput          = CY_TCPWM_INPUT_0,
+    .countInputMode     = CY_TCPWM_INPUT_LEVEL,
+    .countInput         = CY_TCPWM_INPUT_1,
+};
+
+static const cy_stc_sysint_t tsIntrConfig =
+{
+    .intrSrc      = TS_TCPWM_IRQN,
+    .intrPriority = TS_INTR_PRIORITY,
+};
+
+/*********************************************************************
+* Module Variables                                                   *
+**********************************************************************/
+static volatile uint32_t        tsHigh = 0u;        /* wraps so far, ISR */
+
+static cy_stc_ble_conn_handle_t tsConn;
+static uint16_t                 tsCount[REGS_COUNT];    /* in the last value */
+static bool                     tsPending = false;      /* notify owed       */
+static TickType_t               tsLastValue = 0u;
+static TickType_t               tsLastNotify = 0u;
+static uint8_t                  tsValue[TS_VALUE_SIZE];
+
+/*******************************************************************************
+* Function: Ts_Put16 / Ts_Put32
+* Description:
+*    Little endian field writers for the TIMESTAMP value
+*******************************************************************************/
+static void Ts_Put16(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8u);
+}
+
+static void Ts_Put32(uint8_t *p, uint32_t v)
+{
+    Ts_Put16(&p[0], v);
+    Ts_Put16(&p[2], v >> 16u);
+}
+
+/*******************************************************************************
+* Function: Ts_Isr
+* Input:    void
+* Return:   void
+* Description:
+*    Terminal count of the counter, once every 2^32 ticks
+*******************************************************************************/
+static void Ts_Isr(void)
+{
+    Cy_TCPWM_ClearInterrupt(TS_TCPWM_HW, TS_TCPWM_CNT_NUM, CY_TCPWM_INT_ON_TC);
+    tsHigh++;
+}
+
+/*******************************************************************************
+* Function: Ts_Init
+* Input:    void
+* Return:   void
+* Description:
+*    Sets up the counter clock and starts the counter. Call before anything
+*    that stamps, and before the scheduler.
+*******************************************************************************/
+void Ts_Init(void)
+{
+    (void)Cy_SysClk_PeriphAssignDivider(TS_TCPWM_PCLK, CY_SYSCLK_DIV_16_BIT, TS_CLOCK_DIV_NUM);
+    (void)Cy_SysClk_PeriphSetDivider(CY_SYSCLK_DIV_16_BIT, TS_CLOCK_DIV_NUM, TS_CLOCK_DIVIDER);
+    (void)Cy_SysClk_PeriphEnableDivider(CY_SYSCLK_DIV_16_BIT, TS_CLOCK_DIV_NUM);
+
+    (void)Cy_TCPWM_Counter_Init(TS_TCPWM_HW, TS_TCPWM_CNT_NUM, &tsCounterConfig);
+    Cy_TCPWM_Enable_Multiple(TS_TCPWM_HW, TS_TCPWM_CNT_MASK);
+
+    (void)Cy_SysInt_Init(&tsIntrConfig, &Ts_Isr);
+    NVIC_EnableIRQ(TS_TCPWM_IRQN);
+
+    Cy_TCPWM_TriggerStart(TS_TCPWM_HW, TS_TCPWM_CNT_MASK);
+}
+
+/*******************************************************************************
+* Function: Ts_Now64
+* Input:    void
+* Return:   time since Ts_Init(), TS_HZ ticks
+* Description:
+*    Safe from any context on the CM4. A wrap whose interrupt has not run
+*    yet, e.g. when called with interrupts off, is counted here.
+*******************************************************************************/
+uint64_t Ts_Now64(void)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    uint32_t high = tsHigh;
+    uint32_t low  = Ts_Now();
+
+    if((Cy_TCPWM_GetInterruptStatus(TS_TCPWM_HW, TS_TCPWM_CNT_NUM) & CY_TCPWM_INT_ON_TC) != 0u)
+    {
+        /* Read again so low is surely past the wrap */
+        low = Ts_Now();
+        high++;
+    }
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    return ((uint64_t)high << 32u) | low;
+}
+
+/*******************************************************************************
+* Function: Ts_Advance
+* Input:    ticks - TS_HZ ticks the counter missed
+* Return:   void
+* Description:
+*    Steps the time base forward over a Deep Sleep, in which the counter
+*    stops. Call with interrupts off. The counter itself moves, with its
+*    64 bit extension, so Ts_Now() and Ts_Now64() still agree.
+*******************************************************************************/
+void Ts_Advance(uint32_t ticks)
+{
+    uint32_t low  = Ts_Now();
+    uint32_t next = low + ticks;
+
+    if(next < low)
+    {
+        tsHigh++;
+    }
+    Cy_TCPWM_Counter_SetCounter(TS_TCPWM_HW, TS_TCPWM_CNT_NUM, next);
+}
+
+/*******************************************************************************
+* Function: Ts_Build
+* Input:    void
+* Return:   true if a register changed since the last value
+* Description:
+*    Refreshes tsValue and the TIMESTAMP attribute
+*******************************************************************************/
+static bool Ts_Build(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    regs_change_t change;
+    uint64_t now = Ts_Now64();
+    bool changed = false;
+    uint8_t *p = &tsValue[TS_HEADER_SIZE];
+    uint32_t reg;
+
+    Ts_Put32(&tsValue[0], (uint32_t)now);
+    Ts_Put32(&tsValue[4], (uint32_t)(now >> 32u));
+    Ts_Put32(&tsValue[8], TS_HZ);
+
+    for(reg = 0u; reg < (uint32_t)REGS_COUNT; reg++)
+    {
+        Regs_GetChange((regs_id_t)reg, &change);
+        if(change.count != tsCount[reg])
+        {
+            tsCount[reg] = change.count;
+            changed = true;
+        }
+        p[0] = change.code;
+        Ts_Put16(&p[1], change.count);
+        Ts_Put32(&p[3], change.time);
+        p += TS_REG_SIZE;
+    }
+
+    handleValuePair.attrHandle = CY_BLE_LED_TIMESTAMP_CHAR_HANDLE;
+    handleValuePair.value.val  = tsValue;
+    handleValuePair.value.len  = TS_VALUE_SIZE;
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handleValuePair);
+
+    return changed;
+}
+
+/*******************************************************************************
+* Function: Ts_Process
+* Input:    void
+* Return:   ticks until the next refresh
+* Description:
+*    Called from the BLE task loop once the stack is on. Register changes are
+*    only seen here, so they are picked up within one BLE task pass or
+*    TS_NOTIFY_MS, whichever is later; a MUX sweep folds into one
+*    notification per TS_NOTIFY_MS.
+*******************************************************************************/
+TickType_t Ts_Process(void)
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    TickType_t now = xTaskGetTickCount();
+    TickType_t wait;
+
+    if((now - tsLastNotify) < pdMS_TO_TICKS(TS_NOTIFY_MS))
+    {
+        return pdMS_TO_TICKS(TS_NOTIFY_MS) - (now - tsLastNotify);
+    }
+
+    if(Ts_Build() || ((now - tsLastValue) >= pdMS_TO_TICKS(TS_REFRESH_MS)))
+    {
+        tsPending   = true;
+        tsLastValue = now;
+    }
+
+    /* Nobody listening: the attribute is up to date for a read */
+    if(!Cy_BLE_GATTS_IsNotificationEnabled(&tsConn, CY_BLE_LED_TIMESTAMP_CHAR_HANDLE))
+    {
+        tsPending = false;
+    }
+
+    if(tsPending && (Cy_BLE_GATT_GetBusyStatus(tsConn.attId) == CY_BLE_STACK_STATE_FREE))
+    {
+        handleValuePair.attrHandle = CY_BLE_LED_TIMESTAMP_CHAR_HANDLE;
+        handleValuePair.value.val  = tsValue;
+        handleValuePair.value.len  = TS_VALUE_SIZE;
+        if(Cy_BLE_GATTS_SendNotification(&tsConn, &handleValuePair) == CY_BLE_SUCCESS)
+        {
+            tsPending    = false;
+            tsLastNotify = now;
+        }
+    }
+
+    wait = pdMS_TO_TICKS(TS_REFRESH_MS) - (now - tsLastValue);
+    return tsPending ? pdMS_TO_TICKS(TS_NOTIFY_MS) : wait;
+}
+
+/*******************************************************************************
+* Function: Ts_WriteCCCD
+* Input:    writeReqParameter - the CY_BLE_EVT_GATTS_WRITE_REQ parameter
+* Return:   GATT error to report back to the client
+* Description:
+*    Stores the TIMESTAMP CCCD written by the client; the next pass sends
+*    the current value.
+*******************************************************************************/
+cy_en_ble_gatt_err_code_t Ts_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter)
+{
+    cy_stc_ble_gatts_db_attr_val_info_t dbAttrValInfo =
+    {
+        .handleValuePair = writeReqParameter->handleValPair,
+        .connHandle      = writeReqParameter->connHandle,
+        .flags           = CY_BLE_GATT_DB_PEER_INITIATED,
+        .offset          = 0u
+    };
+
+    tsConn    = writeReqParameter->connHandle;
+    tsPending = true;
+    return Cy_BLE_GATTS_WriteAttributeValueCCCD(&dbAttrValInfo);
+}
+
+/* [] END OF FILE */
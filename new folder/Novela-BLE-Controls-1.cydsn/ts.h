@@ -0,0 +1,94 @@
+/*******************************************************************************
+* File Name: ts.h
+*
+* Version: 1.20
+*
+* Description:
+*   Timestamps. TCPWM0 counter 4 free runs over 32 bits at TS_HZ (100 ns
+*   per tick, wraps after 429 s); its terminal count interrupt extends it
+*   to 64 bits. Samples are stamped on acquisition and every PA, MUX, OSC
+*   and MISC change when its pins switch, all on this one time base.
+*
+*   Ts_Now() is a single counter read, safe from any ISR and from the CM0+.
+*   STREAM frames and register changes carry its low 32 bits; the 64 bit
+*   time in the TIMESTAMP value tells the client which wrap they are in.
+*
+*   The counter stops in Deep Sleep, like every TCPWM. The acquisition
+*   holds Deep Sleep off while it runs, so stamps within a stream are on
+*   one unbroken time base. Between streams the tickless idle (power.h)
+*   steps the counter forward by the time it slept, measured on clk_lf,
+*   so the time keeps up with real time to within one clk_lf period
+*   (31 us) per Deep Sleep.
+*
+*   TIMESTAMP value, little endian; read, and notified after a register
+*   change (at most every TS_NOTIFY_MS) or every TS_REFRESH_MS:
+*       [0..7]   time the value was made, 64 bit
+*       [8..11]  TS_HZ
+*       then per register (PA, MUX, OSC, MISC) TS_REG_SIZE bytes:
+*       [0]      code on the pins
+*       [1..2]   number of changes since power up, wraps
+*       [3..6]   time of the last change, low 32 bits
+*
+* Owners:
+*   peter@novelaneuro.com
+
+********************************************************************************
+* Copyright 2019, Novela Neuro.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef TS_H
+
+    #define TS_H
+
+    #include <project.h>
+
+    /***************************************
+    *           Constants
+    ***************************************/
+    /* The Timer component in TopDesign is not placed, so the time base runs
+       TCPWM0 counter 4 directly from its own peripheral clock */
+    #define TS_TCPWM_HW                 TCPWM0
+    #define TS_TCPWM_CNT_NUM            (4u)
+    #define TS_TCPWM_CNT_MASK           (1UL << TS_TCPWM_CNT_NUM)
+    #define TS_TCPWM_PCLK               PCLK_TCPWM0_CLOCKS4
+    #define TS_TCPWM_IRQN               tcpwm_0_interrupts_4_IRQn
+    #define TS_CLOCK_DIV_NUM            (3u)    /* 16 bit divider, #2 is DIAG      */
+    #define TS_CLOCK_DIVIDER            (4u)    /* clk_peri 50 MHz / 5 = 10 MHz    */
+    #define TS_HZ                       (10000000u)
+    #define TS_INTR_PRIORITY            (7u)    /* once per wrap, never urgent     */
+
+    #define TS_HEADER_SIZE              (12u)
+    #define TS_REG_SIZE                 (7u)
+    #define TS_VALUE_SIZE               (TS_HEADER_SIZE + (4u * TS_REG_SIZE))  /* 40, REGS_COUNT */
+    #define TS_NOTIFY_MS                (20u)
+    #define TS_REFRESH_MS               (1000u)
+
+    /***************************************
+    *           Function Prototypes
+    ***************************************/
+    /*******************************************************************************
+    * Function: Ts_Now
+    * Input:    void
+    * Return:   time, low 32 bits, TS_HZ ticks
+    *******************************************************************************/
+    __STATIC_INLINE uint32_t Ts_Now(void)
+    {
+        return Cy_TCPWM_Counter_GetCounter(TS_TCPWM_HW, TS_TCPWM_CNT_NUM);
+    }
+
+#if !(CY_CPU_CORTEX_M0P)
+    #include "FreeRTOS.h"
+
+    void       Ts_Init(void);
+    uint64_t   Ts_Now64(void);
+    void       Ts_Advance(uint32_t ticks);
+    TickType_t Ts_Process(void);
+    cy_en_ble_gatt_err_code_t Ts_WriteCCCD(cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter);
+#endif
+
+#endif
+
+/* [] END OF FILE */